@@ -0,0 +1,11 @@
+/* common configuration */
+#define CONFIG_CRC16_ENABLED
+#define CONFIG_OVERDRIVE_ENABLED
+
+/* CRC algorithms may be chosen by the benchmark build */
+#ifndef CONFIG_CRC8_ALGO
+# define CONFIG_CRC8_ALGO CRC8_TAB_16LH
+#endif
+#ifndef CONFIG_CRC16_ALGO
+# define CONFIG_CRC16_ALGO CRC16_TAB_16LH
+#endif
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/*
+ * Bus time benchmark.
+ *
+ * Runs basic 1-wire service and DSTherm driver activities against simulated
+ * buses of various sizes and reports CPU time spent by the library together
+ * with the simulated bus occupancy (slots counts multiplied by the slots
+ * durations, as bit-banged by the library). The output is intended to be
+ * used as a regression baseline for changes in the search and DSTherm code.
+ */
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "OneWireNg_Simulated.h"
+#include "drivers/DSTherm.h"
+
+#define TAB_SZ(t) (sizeof(t)/sizeof(t[0]))
+
+/*
+ * Benchmark routine is repeated until performing min. number of operations
+ * or exceeding max. CPU time (CPU time accuracy).
+ */
+#define MIN_OPS 2048
+#define MAX_CPU_TIME (CLOCKS_PER_SEC / 5)
+
+typedef OneWireNg_Simulated::Stats Stats;
+
+class Bench
+{
+public:
+    Bench(size_t n): _n(n), _dsth(_ow)
+    {
+        _ids = new OneWireNg::Id[n];
+        _found = new OneWireNg::Id[n];
+        _present = new bool[n];
+        _temps = new long[n];
+        _slaves = new OneWireNg_Simulated::DSThermSlave*[n];
+
+        /* pseudo-random serial numbers (LCG), reproducible between runs */
+        unsigned long sn = 0x5eed;
+        for (size_t i = 0; i < n; i++) {
+            sn = (sn * 1103515245UL + 12345UL) & 0xffffffffUL;
+            OneWireNg_Simulated::Slave::makeId(
+                _ids[i], DSTherm::DS28EA00, sn & 0xffffffUL);
+            _slaves[i] = new OneWireNg_Simulated::DSThermSlave(_ids[i]);
+            _slaves[i]->setTemp(20000 + 125 * (long)i);
+            _ow.attach(*_slaves[i]);
+        }
+    }
+
+    ~Bench()
+    {
+        _ow.detachAll();
+        for (size_t i = 0; i < _n; i++)
+            delete _slaves[i];
+        delete[] _slaves;
+        delete[] _temps;
+        delete[] _present;
+        delete[] _found;
+        delete[] _ids;
+    }
+
+    /* whole bus search */
+    unsigned long search()
+    {
+        OneWireNg::Id id;
+        OneWireNg::ErrorCode ec;
+        unsigned long ops = 0;
+
+        _ow.searchReset();
+        do {
+            ec = _ow.search(id);
+            assert(ec == OneWireNg::EC_MORE || ec == OneWireNg::EC_DONE);
+            ops++;
+        } while (ec == OneWireNg::EC_MORE);
+
+        assert(ops == _n);
+        return ops;
+    }
+
+    /* whole bus search in a single call */
+    unsigned long searchAll()
+    {
+        size_t n;
+        OneWireNg::ErrorCode ec = _ow.searchAll(_found, _n, &n);
+        assert(ec == OneWireNg::EC_SUCCESS && n == _n);
+        (void)ec;
+        return n;
+    }
+
+    /* verify the bus against the known set of devices (no changes) */
+    unsigned long searchDelta()
+    {
+        size_t n;
+        OneWireNg::ErrorCode ec =
+            _ow.searchDelta(_ids, _n, _present, _found, _n, &n);
+        assert(ec == OneWireNg::EC_SUCCESS && !n);
+        (void)ec;
+        return _n;
+    }
+
+    /* address each device on the bus */
+    unsigned long addressSingle()
+    {
+        for (size_t i = 0; i < _n; i++) {
+            OneWireNg::ErrorCode ec = _ow.addressSingle(_ids[i]);
+            assert(ec == OneWireNg::EC_SUCCESS);
+            (void)ec;
+        }
+        return _n;
+    }
+
+    /* address each device on the bus by resume command */
+    unsigned long resume()
+    {
+        for (size_t i = 0; i < _n; i++) {
+            /* not measured */
+            Stats st = _ow.getStats();
+            unsigned long t = _ow.getTime();
+            clock_t c = clock();
+            _ow.addressSingle(_ids[i]);
+            unmeasure(st, t, c);
+
+            OneWireNg::ErrorCode ec = _ow.resume();
+            assert(ec == OneWireNg::EC_SUCCESS);
+            (void)ec;
+        }
+        return _n;
+    }
+
+    /* convert temperature on all sensors (bus scanned for completion) */
+    unsigned long convertTempAll()
+    {
+        OneWireNg::ErrorCode ec = _dsth.convertTempAll();
+        assert(ec == OneWireNg::EC_SUCCESS);
+        (void)ec;
+        return 1;
+    }
+
+    /* read scratchpad of each sensor on the bus */
+    unsigned long readScratchpad()
+    {
+        MAKE_SCRATCHPAD(scrpd);
+
+        for (size_t i = 0; i < _n; i++) {
+            OneWireNg::ErrorCode ec = _dsth.readScratchpad(_ids[i], scrpd);
+            assert(ec == OneWireNg::EC_SUCCESS);
+            (void)ec;
+        }
+        return _n;
+    }
+
+    /* read temperature of each sensor on the bus (known resolution) */
+    unsigned long readTemp()
+    {
+        for (size_t i = 0; i < _n; i++) {
+            OneWireNg::ErrorCode ec =
+                _dsth.readTemp(_ids[i], DSTherm::RES_12_BIT, &_temps[i]);
+            assert(ec == OneWireNg::EC_SUCCESS);
+            (void)ec;
+        }
+        return _n;
+    }
+
+    /* read temperatures of all sensors on the bus (truncated reads) */
+    unsigned long sampleAll()
+    {
+        sampleAll(false);
+        return _n;
+    }
+
+    /* read temperatures of all sensors on the bus (full, validated reads) */
+    unsigned long sampleAllValidate()
+    {
+        sampleAll(true);
+        return _n;
+    }
+
+    /* read scratchpad of each sensor on the bus in overdrive mode */
+    unsigned long readScratchpadOd()
+    {
+        /* not measured */
+        Stats st = _ow.getStats();
+        unsigned long t = _ow.getTime();
+        clock_t c = clock();
+        _ow.overdriveAll();
+        unmeasure(st, t, c);
+
+        unsigned long ops = readScratchpad();
+
+        st = _ow.getStats();
+        t = _ow.getTime();
+        c = clock();
+        _ow.setOverdrive(false);
+        _ow.reset();
+        unmeasure(st, t, c);
+
+        return ops;
+    }
+
+    typedef unsigned long (Bench::*BenchFun)();
+
+    /*
+     * Run benchmark routine and print its results.
+     */
+    void run(const char *name, BenchFun fun)
+    {
+        unsigned long ops = 0;
+
+        _ow.resetStats();
+        memset(&_excl, 0, sizeof(_excl));
+        _clkExcl = 0;
+        _timeExcl = 0;
+
+        unsigned long t = _ow.getTime();
+        clock_t c = clock();
+        do {
+            ops += (this->*fun)();
+        } while (ops < MIN_OPS && clock() - c < MAX_CPU_TIME);
+        c = clock() - c - _clkExcl;
+        t = _ow.getTime() - t - _timeExcl;
+
+        Stats st = _ow.getStats();
+        sub(st.std, _excl.std);
+        sub(st.od, _excl.od);
+        st.busTime -= _excl.busTime;
+
+        double cpu = 1000000.0 * c / CLOCKS_PER_SEC;
+
+        printf("%-18s %5lu %7lu %11.2f %11.1f %13.1f %9lu %9lu %9lu "
+            "%9lu %9lu %9lu\n",
+            name, (unsigned long)_n, ops, cpu / ops,
+            (double)st.busTime / ops, (double)t / ops,
+            st.std.reset, st.std.write0, st.std.write1,
+            st.od.reset, st.od.write0, st.od.write1);
+    }
+
+    static void header()
+    {
+        printf("%-18s %5s %7s %11s %11s %13s %9s %9s %9s %9s %9s %9s\n",
+            "benchmark", "devs", "ops", "cpu[us/op]", "bus[us/op]",
+            "clock[us/op]", "std-rst", "std-wr0", "std-wr1",
+            "od-rst", "od-wr0", "od-wr1");
+    }
+
+private:
+    void sampleAll(bool validate)
+    {
+        /* conversion not measured */
+        Stats st = _ow.getStats();
+        unsigned long t = _ow.getTime();
+        clock_t c = clock();
+        OneWireNg::ErrorCode ec = _dsth.convertTempAll();
+        unmeasure(st, t, c);
+
+        /* no conversion wait; the sensors are already converted */
+        ec = _dsth.sampleAll(_ids, _n, _temps, NULL, validate, 0);
+        assert(ec == OneWireNg::EC_SUCCESS);
+        (void)ec;
+    }
+
+    static void sub(OneWireNg_Simulated::SlotCounters& a,
+        const OneWireNg_Simulated::SlotCounters& b)
+    {
+        a.reset -= b.reset;
+        a.write0 -= b.write0;
+        a.write1 -= b.write1;
+    }
+
+    static void add(OneWireNg_Simulated::SlotCounters& a,
+        const OneWireNg_Simulated::SlotCounters& b)
+    {
+        a.reset += b.reset;
+        a.write0 += b.write0;
+        a.write1 += b.write1;
+    }
+
+    /*
+     * Exclude bus activity and CPU time since @c st, @c t, @c c from the
+     * benchmark results.
+     */
+    void unmeasure(const Stats& st, unsigned long t, clock_t c)
+    {
+        Stats d = _ow.getStats();
+
+        sub(d.std, st.std);
+        sub(d.od, st.od);
+        add(_excl.std, d.std);
+        add(_excl.od, d.od);
+        _excl.busTime += d.busTime - st.busTime;
+
+        _clkExcl += clock() - c;
+        _timeExcl += _ow.getTime() - t;
+    }
+
+    size_t _n;
+    OneWireNg::Id *_ids;
+    OneWireNg::Id *_found;  /* searchAll() results */
+    bool *_present;         /* searchDelta() results */
+    long *_temps;           /* sampleAll() results */
+    OneWireNg_Simulated::DSThermSlave **_slaves;
+
+    OneWireNg_Simulated _ow;
+    DSTherm _dsth;
+
+    /* excluded from the results */
+    Stats _excl;
+    clock_t _clkExcl;
+    unsigned long _timeExcl;
+};
+
+int main(void)
+{
+    static const size_t devs[] = { 1, 8, 64, 256 };
+
+    Bench::header();
+    for (size_t i = 0; i < TAB_SZ(devs); i++)
+    {
+        Bench b(devs[i]);
+
+        b.run("search", &Bench::search);
+        b.run("searchAll", &Bench::searchAll);
+        b.run("searchDelta", &Bench::searchDelta);
+        b.run("addressSingle", &Bench::addressSingle);
+        b.run("resume", &Bench::resume);
+        b.run("convertTempAll", &Bench::convertTempAll);
+        b.run("readScratchpad", &Bench::readScratchpad);
+        b.run("readScratchpad-od", &Bench::readScratchpadOd);
+        b.run("readTemp", &Bench::readTemp);
+        b.run("sampleAll", &Bench::sampleAll);
+        b.run("sampleAll-validate", &Bench::sampleAllValidate);
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/*
+ * CRC benchmark.
+ *
+ * The benchmark is built for each of the CRC algorithms (see Makefile) and
+ * reports throughput of CRC-8/CRC-16 calculation for the configured algorithm
+ * over inputs of various lengths (ROM id, scratchpad, memory page, memory
+ * image).
+ */
+#include <cstdio>
+#include <ctime>
+
+#include "OneWireNg.h"
+
+#define TAB_SZ(t) (sizeof(t)/sizeof(t[0]))
+
+#define __STR(s) #s
+#define STR(s) __STR(s)
+
+#ifdef CONFIG_PLATFORM_CRC
+# define PLATFORM_SFX "+PLATFORM"
+#else
+# define PLATFORM_SFX ""
+#endif
+
+/* number of bytes processed per benchmark */
+#define BENCH_BYTES (64UL * 1024 * 1024)
+
+static uint8_t buf[0x1000];
+
+/* prevents optimizing out of the benchmarked calculations */
+static volatile unsigned long sink;
+
+typedef unsigned long (*CrcFun)(size_t len);
+
+static unsigned long crc8Fun(size_t len)
+{
+    uint8_t crc = 0;
+    for (unsigned long i = 0; i < BENCH_BYTES / len; i++)
+        crc = OneWireNg::crc8(buf, len, crc);
+    return crc;
+}
+
+#ifdef CONFIG_CRC16_ENABLED
+static unsigned long crc16Fun(size_t len)
+{
+    uint16_t crc = 0;
+    for (unsigned long i = 0; i < BENCH_BYTES / len; i++)
+        crc = OneWireNg::crc16(buf, len, crc);
+    return crc;
+}
+#endif
+
+static void run(const char *name, const char *algo, CrcFun fun)
+{
+    static const size_t lens[] = { 8, 9, 32, 256, sizeof(buf) };
+
+    for (size_t i = 0; i < TAB_SZ(lens); i++)
+    {
+        clock_t c = clock();
+        sink = fun(lens[i]);
+        c = clock() - c;
+
+        double secs = (double)c / CLOCKS_PER_SEC;
+        double bytes = (double)(BENCH_BYTES / lens[i]) * lens[i];
+
+        printf("%-6s %-28s %6lu %10.2f %10.1f\n", name, algo,
+            (unsigned long)lens[i], 1e9 * secs / bytes,
+            bytes / (1024 * 1024) / secs);
+    }
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < sizeof(buf); i++)
+        buf[i] = (uint8_t)(i * 7 + (i >> 8));
+
+    printf("%-6s %-28s %6s %10s %10s\n",
+        "crc", "algorithm", "len", "ns/byte", "MB/s");
+
+    run("crc8", STR(CONFIG_CRC8_ALGO) PLATFORM_SFX, crc8Fun);
+#ifdef CONFIG_CRC16_ENABLED
+    run("crc16", STR(CONFIG_CRC16_ALGO) PLATFORM_SFX, crc16Fun);
+#endif
+    return 0;
+}
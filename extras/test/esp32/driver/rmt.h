@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/* host model stub; see esp32_sim.h */
+#include "esp32_sim.h"
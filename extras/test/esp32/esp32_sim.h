@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/*
+ * Host model of the Arduino ESP32 core & ESP-IDF services used by the ESP32
+ * RMT platform (legacy RMT driver, GPIO matrix, FreeRTOS ring buffer).
+ *
+ * The RMT TX channel drives a simulated 1-wire bus (@ref esp32_sim_attach()).
+ * Transmitted items are turned into the bus line waveform (master's slots
+ * with slaves responses) and recorded by the RMT RX channel the same way the
+ * hardware does: recording starts on the first edge and a frame is finished
+ * by the line state unchanged for longer than the RX idle threshold. The bus
+ * virtual clock is advanced by the RX idle threshold after each transmission
+ * (the frame reception completion).
+ */
+#ifndef __OWNG_TEST_ESP32_SIM__
+#define __OWNG_TEST_ESP32_SIM__
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "OneWireNg_Simulated.h"
+#include "OneWireNg_Timings.h"
+
+/* Arduino */
+#define INPUT   0x01
+#define PULLUP  0x04
+
+static inline void pinMode(unsigned pin, unsigned mode) {
+    (void)pin; (void)mode;
+}
+
+/* ESP-IDF errors */
+typedef int esp_err_t;
+
+#define ESP_OK              0
+#define ESP_FAIL            -1
+#define ESP_ERR_TIMEOUT     0x107
+
+/* GPIO */
+typedef enum {
+    GPIO_NUM_0 = 0
+} gpio_num_t;
+
+typedef enum {
+    GPIO_MODE_INPUT_OUTPUT_OD,
+    GPIO_MODE_INPUT_OUTPUT
+} gpio_mode_t;
+
+#define RMT_SIG_OUT0_IDX    87
+#define RMT_SIG_IN0_IDX     83
+
+static inline void gpio_matrix_out(
+    uint32_t pin, uint32_t sig, bool outInv, bool oenInv)
+{
+    (void)pin; (void)sig; (void)outInv; (void)oenInv;
+}
+
+static inline void gpio_matrix_in(uint32_t pin, uint32_t sig, bool inv) {
+    (void)pin; (void)sig; (void)inv;
+}
+
+/* FreeRTOS */
+typedef void *RingbufHandle_t;
+typedef uint32_t TickType_t;
+
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+/* RMT */
+typedef enum {
+    RMT_CHANNEL_0,
+    RMT_CHANNEL_1,
+    RMT_CHANNEL_2,
+    RMT_CHANNEL_3,
+    RMT_CHANNEL_MAX
+} rmt_channel_t;
+
+typedef enum {
+    RMT_MODE_TX,
+    RMT_MODE_RX
+} rmt_mode_t;
+
+typedef enum {
+    RMT_IDLE_LEVEL_LOW,
+    RMT_IDLE_LEVEL_HIGH
+} rmt_idle_level_t;
+
+typedef struct {
+    union {
+        struct {
+            uint32_t duration0 :15;
+            uint32_t level0 :1;
+            uint32_t duration1 :15;
+            uint32_t level1 :1;
+        };
+        uint32_t val;
+    };
+} rmt_item32_t;
+
+typedef struct {
+    rmt_mode_t rmt_mode;
+    rmt_channel_t channel;
+    gpio_num_t gpio_num;
+    uint8_t clk_div;
+    uint8_t mem_block_num;
+    uint32_t flags;
+    struct {
+        bool idle_output_en;
+        rmt_idle_level_t idle_level;
+    } tx_config;
+    struct {
+        uint16_t idle_threshold;
+        uint8_t filter_ticks_thresh;
+        bool filter_en;
+    } rx_config;
+} rmt_config_t;
+
+static inline rmt_config_t __rmt_default_config(
+    rmt_mode_t mode, unsigned pin, rmt_channel_t ch)
+{
+    rmt_config_t cfg = {};
+    cfg.rmt_mode = mode;
+    cfg.channel = ch;
+    cfg.gpio_num = (gpio_num_t)pin;
+    cfg.clk_div = 80;
+    cfg.mem_block_num = 1;
+    cfg.rx_config.idle_threshold = 12000;
+    return cfg;
+}
+
+#define RMT_DEFAULT_CONFIG_RX(pin, ch) \
+    __rmt_default_config(RMT_MODE_RX, pin, ch)
+#define RMT_DEFAULT_CONFIG_TX(pin, ch) \
+    __rmt_default_config(RMT_MODE_TX, pin, ch)
+
+/*
+ * Model state
+ */
+#define ESP32_SIM_MAX_LEVELS 256
+
+typedef struct {
+    OneWireNg_Simulated *bus;
+    unsigned ticksPerUs;        /* RMT ticks per usec */
+    unsigned idleTicks;         /* RX idle threshold */
+    bool rxOn;                  /* RX channel recording */
+
+    /* line levels since the recording start */
+    uint8_t level[ESP32_SIM_MAX_LEVELS];
+    unsigned long ticks[ESP32_SIM_MAX_LEVELS];
+    size_t levels;
+
+    /* recorded frame (zero duration terminated) */
+    rmt_item32_t rx[ESP32_SIM_MAX_LEVELS / 2 + 1];
+    size_t rxSize;              /* frame size (bytes); 0: no frame */
+
+    unsigned long frames;       /* recorded frames */
+    unsigned long idleCuts;     /* frames finished before the TX end */
+} esp32_sim_t;
+
+static esp32_sim_t __esp32_sim;
+
+/**
+ * Attach simulated 1-wire @c bus to the RMT channels GPIO.
+ */
+static inline void esp32_sim_attach(OneWireNg_Simulated *bus)
+{
+    __esp32_sim.bus = bus;
+    __esp32_sim.frames = 0;
+    __esp32_sim.idleCuts = 0;
+}
+
+/**
+ * Get the model state.
+ */
+static inline const esp32_sim_t& esp32_sim_get() {
+    return __esp32_sim;
+}
+
+/* the line is in the @c level state for @c us */
+static inline void __esp32_sim_line(int level, unsigned long us)
+{
+    esp32_sim_t& sim = __esp32_sim;
+
+    /* recording starts on the first edge (the line is released high) */
+    if (!sim.rxOn || (!sim.levels && level))
+        return;
+
+    if (sim.levels > 0 && sim.level[sim.levels - 1] == level) {
+        sim.ticks[sim.levels - 1] += us * sim.ticksPerUs;
+    } else {
+        assert(sim.levels < ESP32_SIM_MAX_LEVELS);
+        sim.level[sim.levels] = (uint8_t)level;
+        sim.ticks[sim.levels] = us * sim.ticksPerUs;
+        sim.levels++;
+    }
+}
+
+/*
+ * Line waveform of a 1-wire slot started by the master's @c lowUs pulse
+ * followed by @c highUs of the released line.
+ */
+static inline void __esp32_sim_slot(unsigned lowUs, unsigned highUs)
+{
+    esp32_sim_t& sim = __esp32_sim;
+
+    if (lowUs >= STD_RESET_LOW)
+    {
+        /* presence pulse (if any) 30 usec after the reset pulse */
+        const unsigned wait = 30, presence = 120;
+
+        __esp32_sim_line(0, lowUs);
+        if (sim.bus->reset() == OneWireNg::EC_SUCCESS) {
+            assert(highUs > wait + presence);
+            __esp32_sim_line(1, wait);
+            __esp32_sim_line(0, presence);
+            __esp32_sim_line(1, highUs - wait - presence);
+        } else
+            __esp32_sim_line(1, highUs);
+    } else
+    if (lowUs < STD_WRITE1_LOW + STD_WRITE1_SMPL)
+    {
+        /* read (write-1) slot; a slave holds the line low for 0 bit */
+        const unsigned hold = 30;
+
+        if (!sim.bus->touchBit(1) && hold > lowUs) {
+            __esp32_sim_line(0, hold);
+            __esp32_sim_line(1, lowUs + highUs - hold);
+        } else {
+            __esp32_sim_line(0, lowUs);
+            __esp32_sim_line(1, highUs);
+        }
+    } else {
+        sim.bus->touchBit(0);
+        __esp32_sim_line(0, lowUs);
+        __esp32_sim_line(1, highUs);
+    }
+}
+
+/* RX frame recorded from the line levels */
+static inline void __esp32_sim_frame()
+{
+    esp32_sim_t& sim = __esp32_sim;
+    size_t n = 0;
+
+    if (!sim.levels)
+        return;
+
+    for (size_t i = 0; i < sim.levels; i++)
+    {
+        /* the line state unchanged for the idle threshold finishes frame */
+        bool idle = (sim.ticks[i] > sim.idleTicks);
+        unsigned long d = (idle ? sim.idleTicks : sim.ticks[i]);
+
+        rmt_item32_t& it = sim.rx[n / 2];
+        if (n & 1) {
+            it.level1 = sim.level[i];
+            it.duration1 = (uint32_t)d;
+        } else {
+            it.val = 0;
+            it.level0 = sim.level[i];
+            it.duration0 = (uint32_t)d;
+        }
+        n++;
+
+        if (idle) {
+            if (i + 1 < sim.levels)
+                sim.idleCuts++;
+            break;
+        }
+    }
+
+    /* zero duration terminates the frame */
+    if (n & 1)
+        sim.rx[n / 2].duration1 = 0;
+    else
+        sim.rx[n / 2].val = 0;
+
+    sim.rxSize = sizeof(rmt_item32_t) * (n / 2 + 1);
+    sim.frames++;
+}
+
+static inline esp_err_t rmt_config(const rmt_config_t *cfg)
+{
+    __esp32_sim.ticksPerUs = 80 / cfg->clk_div;
+    if (cfg->rmt_mode == RMT_MODE_RX) {
+        /* 15-bit RMT ticks counter */
+        assert(cfg->rx_config.idle_threshold < 0x8000);
+        __esp32_sim.idleTicks = cfg->rx_config.idle_threshold;
+    }
+    return ESP_OK;
+}
+
+static inline esp_err_t rmt_set_rx_idle_thresh(
+    rmt_channel_t ch, uint16_t thresh)
+{
+    (void)ch;
+    /* 15-bit RMT ticks counter */
+    assert(thresh < 0x8000);
+    __esp32_sim.idleTicks = thresh;
+    return ESP_OK;
+}
+
+static inline esp_err_t rmt_driver_install(
+    rmt_channel_t ch, size_t rbSize, int flags)
+{
+    (void)ch; (void)rbSize; (void)flags;
+    return ESP_OK;
+}
+
+static inline esp_err_t rmt_driver_uninstall(rmt_channel_t ch) {
+    (void)ch;
+    return ESP_OK;
+}
+
+static inline esp_err_t rmt_get_ringbuf_handle(
+    rmt_channel_t ch, RingbufHandle_t *rb)
+{
+    (void)ch;
+    *rb = &__esp32_sim;
+    return ESP_OK;
+}
+
+static inline esp_err_t rmt_rx_start(rmt_channel_t ch, bool reset)
+{
+    (void)ch; (void)reset;
+    __esp32_sim.rxOn = true;
+    __esp32_sim.levels = 0;
+    __esp32_sim.rxSize = 0;
+    return ESP_OK;
+}
+
+static inline esp_err_t rmt_rx_stop(rmt_channel_t ch)
+{
+    (void)ch;
+    __esp32_sim.rxOn = false;
+    return ESP_OK;
+}
+
+static inline esp_err_t rmt_write_items(rmt_channel_t ch,
+    const rmt_item32_t *items, int n, bool wait)
+{
+    esp32_sim_t& sim = __esp32_sim;
+    (void)ch;
+
+    assert(sim.bus && wait);
+    for (int i = 0; i < n; i++) {
+        assert(!items[i].level0 && items[i].level1);
+        __esp32_sim_slot(items[i].duration0 / sim.ticksPerUs,
+            items[i].duration1 / sim.ticksPerUs);
+    }
+
+    /* TX idle level (high) follows the transmission */
+    __esp32_sim_line(1, sim.idleTicks / sim.ticksPerUs + 1);
+    __esp32_sim_frame();
+
+    /* the frame is received after the RX idle threshold elapses */
+    sim.bus->advanceTime(sim.idleTicks / sim.ticksPerUs);
+    return ESP_OK;
+}
+
+static inline void *xRingbufferReceive(
+    RingbufHandle_t rb, size_t *size, TickType_t wait)
+{
+    (void)rb; (void)wait;
+    *size = __esp32_sim.rxSize;
+    return (__esp32_sim.rxSize ? __esp32_sim.rx : NULL);
+}
+
+static inline void vRingbufferReturnItem(RingbufHandle_t rb, void *item) {
+    (void)rb; (void)item;
+}
+
+static inline esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode)
+{
+    (void)pin;
+    /* push-pull GPIO powers the bus */
+    if (__esp32_sim.bus)
+        __esp32_sim.bus->powerBus(mode == GPIO_MODE_INPUT_OUTPUT);
+    return ESP_OK;
+}
+
+#endif /* __OWNG_TEST_ESP32_SIM__ */
@@ -422,6 +422,126 @@ public:
             assert(!fnd[i] || fnd[i] == -1);
         }
 
+        TEST_SUCCESS();
+    }
+    static void test_searchAll()
+    {
+        Id ids[MAX_TEST_SLAVES];
+        size_t n, i, j;
+        OneWireNg_Test ow;
+
+        /* no devices */
+        assert(ow.searchAll(ids, TAB_SZ(ids), &n) == EC_NO_DEVS && !n);
+        assert(ow.searchAll(ids, 0, &n) == EC_NO_DEVS && !n);
+
+        /* multiple devices */
+        for (i=0; i < TAB_SZ(TEST1_IDS); i++)
+            ow.addSlave(TEST1_IDS[i]);
+
+        assert(ow.searchAll(ids, TAB_SZ(ids), &n) == EC_SUCCESS);
+        assert(n == TAB_SZ(TEST1_IDS));
+
+        for (i=0; i < TAB_SZ(TEST1_IDS); i++) {
+            int fnd = 0;
+            for (j=0; j < n; j++)
+                fnd += cmpId(ids[j], TEST1_IDS[i]);
+            /* each id returned only once */
+            assert(fnd == 1);
+        }
+
+        /* ids table too small */
+        assert(ow.searchAll(ids, n-1, &n) == EC_FULL);
+        assert(n == TAB_SZ(TEST1_IDS)-1);
+        assert(ow.searchAll(ids, 0) == EC_FULL);
+
+        /*
+         * CRC error doesn't stop the process (discrepancy on the CRC part
+         * of the id is a bus error, therefore the id is corrupted elsewhere)
+         */
+        Id idCorrupt;
+        memcpy(&idCorrupt, &TEST1_IDS[0], sizeof(Id));
+        idCorrupt[1] = 0x00;
+        ow.addSlave(idCorrupt);
+
+        assert(ow.searchAll(ids, TAB_SZ(ids), &n) == EC_CRC_ERROR);
+        assert(n == TAB_SZ(TEST1_IDS)+1);
+
+        for (i=0, j=0; i < n; i++) {
+            if (checkCrcId(ids[i]) != EC_SUCCESS) {
+                assert(cmpId(ids[i], idCorrupt));
+                j++;
+            }
+        }
+        assert(j == 1);
+
+        /* filtered search */
+        ow.delAllslaves();
+        for (i=0; i < TAB_SZ(TEST2_IDS); i++)
+            ow.addSlave(TEST2_IDS[i]);
+        ow.searchFilterAdd(0x44);
+        ow.searchFilterAdd(0x2f);
+
+        assert(ow.searchAll(ids, TAB_SZ(ids), &n) == EC_SUCCESS && n == 4);
+        for (i=0; i < n; i++)
+            assert(ids[i][0] == 0x44 || ids[i][0] == 0x2f);
+
+        ow.searchFilterDelAll();
+        ow.searchFilterAdd(0x00);
+        assert(ow.searchAll(ids, TAB_SZ(ids), &n) == EC_NO_DEVS && !n);
+
+        TEST_SUCCESS();
+    }
+    static void test_searchDelta()
+    {
+        Id added[MAX_TEST_SLAVES];
+        bool present[TAB_SZ(TEST1_IDS)];
+        size_t n, i;
+        OneWireNg_Test ow;
+
+        /* no devices */
+        assert(ow.searchDelta(TEST1_IDS, TAB_SZ(TEST1_IDS), present,
+            added, TAB_SZ(added), &n) == EC_NO_DEVS && !n);
+        for (i=0; i < TAB_SZ(TEST1_IDS); i++)
+            assert(!present[i]);
+
+        /* no changes */
+        for (i=0; i < TAB_SZ(TEST1_IDS); i++)
+            ow.addSlave(TEST1_IDS[i]);
+
+        assert(ow.searchDelta(TEST1_IDS, TAB_SZ(TEST1_IDS), present,
+            added, TAB_SZ(added), &n) == EC_SUCCESS && !n);
+        for (i=0; i < TAB_SZ(TEST1_IDS); i++)
+            assert(present[i]);
+
+        /* known slaves removed, new ones added */
+        ow.delAllslaves();
+        for (i=0; i < TAB_SZ(TEST1_IDS); i++) {
+            if (i != 3 && i != 10)
+                ow.addSlave(TEST1_IDS[i]);
+        }
+        ow.addSlave(TEST2_IDS[0]);
+        ow.addSlave(TEST2_IDS[1]);
+
+        assert(ow.searchDelta(TEST1_IDS, TAB_SZ(TEST1_IDS), present,
+            added, TAB_SZ(added), &n) == EC_SUCCESS && n == 2);
+        for (i=0; i < TAB_SZ(TEST1_IDS); i++)
+            assert(present[i] == (i != 3 && i != 10));
+        assert((cmpId(added[0], TEST2_IDS[0]) && cmpId(added[1], TEST2_IDS[1])) ||
+            (cmpId(added[0], TEST2_IDS[1]) && cmpId(added[1], TEST2_IDS[0])));
+
+        /* added table too small */
+        assert(ow.searchDelta(TEST1_IDS, TAB_SZ(TEST1_IDS), present,
+            added, 1, &n) == EC_FULL && n == 1);
+
+        /* CRC error of a new slave */
+        Id idCorrupt;
+        memcpy(&idCorrupt, &TEST1_IDS[0], sizeof(Id));
+        idCorrupt[1] = 0x00;
+        ow.addSlave(idCorrupt);
+
+        assert(ow.searchDelta(TEST1_IDS, TAB_SZ(TEST1_IDS), present,
+            added, TAB_SZ(added), &n) == EC_CRC_ERROR && n == 3);
+
         TEST_SUCCESS();
     }
 };
@@ -435,6 +555,8 @@ int main(void)
     OneWireNg_Test::test_search();
     OneWireNg_Test::test_filter();
     OneWireNg_Test::test_filteredSearch();
+    OneWireNg_Test::test_searchAll();
+    OneWireNg_Test::test_searchDelta();
 
     return 0;
 }
@@ -11,24 +11,397 @@
  */
 
 #include "common.h"
+#include "OneWireNg_BitBangMultiT.h"
 
-class OneWireNg_BitBang_Test: OneWireNg_BitBang
+#define TRACE_SZ 0x1000
+
+/*
+ * GPIO activity is traced as: 'L' - data bus set low, 'H' - data bus
+ * released, 'S' - data bus sampled, 'P' - power on (data bus GPIO set high
+ * in the output mode).
+ */
+struct GpioTrace
+{
+    GpioTrace() {
+        clear(0xffff);
+    }
+
+    void trace(char c) {
+        assert(_tlen < TRACE_SZ);
+        _trace[_tlen++] = c;
+    }
+
+    /* clear the trace and set response bits shifted out on bus sampling */
+    void clear(uint32_t resp) {
+        _tlen = 0;
+        _resp = resp;
+    }
+
+    int sample() {
+        int bit = (int)(_resp & 1);
+        _resp = (_resp >> 1) | (_resp << 31);
+        trace('S');
+        return bit;
+    }
+
+    bool operator==(const GpioTrace& t) const {
+        return (_tlen == t._tlen && !memcmp(_trace, t._trace, _tlen));
+    }
+
+    size_t _tlen;
+    char _trace[TRACE_SZ];
+    uint32_t _resp;
+};
+
+/*
+ * GPIO interface implemented by the template (no virtual calls).
+ */
+class OneWireNg_BitBangT_Test:
+    public OneWireNg_BitBangT<OneWireNg_BitBangT_Test>, public GpioTrace
+{
+    friend class OneWireNg_BitBangT<OneWireNg_BitBangT_Test>;
+
+private:
+    int readGpioIn(GpioType gpio) {
+        return sample();
+    }
+
+    void writeGpioOut(GpioType gpio, int state) {}
+
+    void setGpioAsInput(GpioType gpio) {
+        trace('H');
+    }
+
+    void setGpioAsOutput(GpioType gpio, int state) {
+        trace(state ? 'P' : 'L');
+    }
+};
+
+/*
+ * Port-parallel bit-banging of 3 buses (port bits 0, 2, 5). Port activity
+ * is traced as pairs of operation ('L', 'H', 'P' as above; 'S' - port
+ * sampled) and port mask.
+ */
+class OneWireNg_BitBangMultiT_Test:
+    public OneWireNg_BitBangMultiT<OneWireNg_BitBangMultiT_Test, uint8_t>
+{
+    friend class OneWireNg_BitBangMultiT<OneWireNg_BitBangMultiT_Test, uint8_t>;
+
+private:
+    /* driven low, driven high, touched in the current slot GPIOs */
+    uint8_t _low, _high, _slot;
+
+    void trace(char op, uint8_t m) {
+        assert(_tlen + 2 <= TRACE_SZ);
+        _trace[_tlen++] = op;
+        _trace[_tlen++] = (char)m;
+    }
+
+    /* response bits are shifted out for buses touched in the current slot */
+    uint8_t readPortIn()
+    {
+        uint8_t v = 0;
+
+        for (int b = 0; b < _busNum; b++) {
+            uint8_t pin = _busMsk[b];
+
+            if (_high & pin) {
+                v |= pin;
+            } else
+            if (_slot & pin) {
+                if (!(_low & pin) && (_resp[b] & 1))
+                    v |= pin;
+                _resp[b] = (_resp[b] >> 1) | (_resp[b] << 31);
+            } else
+            if (!(_low & pin)) {
+                v |= pin;
+            }
+        }
+        _slot = 0;
+        trace('S', 0);
+        return v;
+    }
+
+    void setPortAsInput(uint8_t m) {
+        _low &= ~m;
+        _high &= ~m;
+        trace('H', m);
+    }
+
+    void setPortAsOutput(uint8_t m, int state)
+    {
+        if (state) {
+            _high |= m;
+            _low &= ~m;
+        } else {
+            _low |= m;
+            _high &= ~m;
+            _slot |= m;
+        }
+        trace(state ? 'P' : 'L', m);
+    }
+
+public:
+    OneWireNg_BitBangMultiT_Test(): _low(0), _high(0), _slot(0), _tlen(0)
+    {
+        assert(addBus(0x01) == 0 && addBus(0x04) == 1 && addBus(0x20) == 2);
+        clear();
+    }
+
+    void clear(uint32_t r0 = 0xffffffffUL,
+        uint32_t r1 = 0xffffffffUL, uint32_t r2 = 0xffffffffUL)
+    {
+        _tlen = 0;
+        _resp[0] = r0;
+        _resp[1] = r1;
+        _resp[2] = r2;
+    }
+
+    size_t count(char op)
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < _tlen; i += 2)
+            if (_trace[i] == op) n++;
+        return n;
+    }
+
+    static void test_multiReset()
+    {
+        OneWireNg_BitBangMultiT_Test ow;
+
+        /* presence pulse on buses 0, 2 */
+        ow.clear(0, 1, 0);
+        assert(ow.getBusesNum() == 3);
+        assert(ow.reset() == 0x05);
+        assert(ow._tlen == 3*2 && !memcmp(ow._trace, "L\x25H\x25S\x00", 6));
+
+        /* only selected buses are reset */
+        ow.clear(0, 0, 0);
+        assert(ow.reset(0x03) == 0x03);
+        assert(ow._trace[1] == 0x05);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_multiTouch()
+    {
+        OneWireNg_BitBangMultiT_Test ow;
+
+        /* write-1 on buses 0, 2 and write-0 on bus 1 in the same slot */
+        assert(ow.touchBit(0x07, 0x05) == 0x05);
+        assert(ow._tlen == 4*2 &&
+            !memcmp(ow._trace, "L\x25H\x21S\x00H\x04", 8));
+
+        /* per-bus bytes; no slaves response */
+        uint8_t out[3][2] = {{0x00, 0xff}, {0x12, 0x34}, {0xa5, 0x5a}};
+        uint8_t buf[3][2];
+        memcpy(buf, out, sizeof(buf));
+
+        ow.clear();
+        ow.touchBytes(0x07, buf[0], 2);
+        assert(!memcmp(buf, out, sizeof(buf)) && ow.count('S') == 2*8);
+
+        /* per-bus read */
+        ow.clear(0x3412, 0x7856, 0xbc9a);
+        ow.readBytes(0x07, buf[0], 2);
+        assert(buf[0][0] == 0x12 && buf[0][1] == 0x34 &&
+            buf[1][0] == 0x56 && buf[1][1] == 0x78 &&
+            buf[2][0] == 0x9a && buf[2][1] == 0xbc);
+
+        /* not selected bus is neither touched nor written */
+        memset(buf, 0, sizeof(buf));
+        ow.clear(0xffff, 0, 0xffff);
+        ow.readBytes(0x05, buf[0], 2);
+        assert(buf[0][0] == 0xff && buf[1][0] == 0 && buf[2][1] == 0xff);
+        for (size_t i = 0; i < ow._tlen; i += 2)
+            assert(!(ow._trace[i+1] & 0x04));
+
+        /* broadcast: 4 write-0 and 4 write-1 slots */
+        ow.clear();
+        ow.writeByte(0x06, 0xf0);
+        assert(ow.count('S') == 8 && ow.count('L') == 8 &&
+            ow.count('H') == 4*2 + 4);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_multiPowerBus()
+    {
+        OneWireNg_BitBangMultiT_Test ow;
+        uint8_t buf[3];
+
+        ow.powerBus(0x02, true);
+        assert(ow._tlen == 2 && ow._trace[0] == 'P' && ow._trace[1] == 0x04);
+
+        /* unpowered before the next activity */
+        ow.clear();
+        ow.readBytes(0x01, buf, 1);
+        assert(ow._trace[0] == 'H' && ow._trace[1] == 0x04 && !ow._pwrMsk);
+
+        TEST_SUCCESS();
+    }
+
+    size_t _tlen;
+    char _trace[TRACE_SZ];
+    uint32_t _resp[3];
+};
+
+class OneWireNg_BitBang_Test: OneWireNg_BitBang, GpioTrace
 {
 private:
     OneWireNg_BitBang_Test(): OneWireNg_BitBang(false) {}
 
     int readGpioIn(GpioType gpio) {
-        return 1;
+        return sample();
     }
 
     void writeGpioOut(GpioType gpio, int state) {}
 
-    void setGpioAsInput(GpioType gpio) {}
+    void setGpioAsInput(GpioType gpio) {
+        trace('H');
+    }
+
+    void setGpioAsOutput(GpioType gpio, int state) {
+        trace(state ? 'P' : 'L');
+    }
+
+public:
+    /*
+     * Byte touching engine shall produce the same bus activity and results
+     * as the generic, bit by bit implementation.
+     */
+    static void test_touchByte()
+    {
+        OneWireNg_BitBang_Test ow;
+        char trace[TRACE_SZ];
+        size_t tlen;
 
-    void setGpioAsOutput(GpioType gpio, int state) {}
+        for (int od = 0; od < 2; od++)
+        {
+            ow.setOverdrive(od != 0);
+
+            for (unsigned b = 0; b < 0x100; b++)
+            {
+                unsigned long resp = 0x5a3c0000UL | (b << 8) | (b ^ 0xff);
+
+                ow.clear(resp);
+                uint8_t r1 = ow.OneWireNg::touchByte((uint8_t)b);
+                tlen = ow._tlen;
+                memcpy(trace, ow._trace, tlen);
+
+                ow.clear(resp);
+                uint8_t r2 = ow.touchByte((uint8_t)b);
+                assert(r1 == r2);
+                assert(tlen == ow._tlen && !memcmp(trace, ow._trace, tlen));
+            }
+        }
+        ow.setOverdrive(false);
+
+        /* response is read LSB first */
+        ow.clear(0xa5);
+        assert(ow.readByte() == 0xa5);
+        ow.clear(0xffff);
+        assert(ow.touchByte(0x0f) == 0x0f);
+
+        /* 4 write-0 and 4 write-1 slots */
+        ow.clear(0xffff);
+        ow.writeByte(0xf0);
+        assert(ow._tlen == 4*2 + 4*3 &&
+            !memcmp(ow._trace, "LHLHLHLHLHSLHSLHSLHS", 20));
+
+        TEST_SUCCESS();
+    }
+
+    static void test_touchBytes()
+    {
+        OneWireNg_BitBang_Test ow;
+        OneWireNg& owng = ow;
+        const uint8_t out[] = { 0x00, 0xff, 0x12, 0x34, 0xcc };
+        uint8_t in[sizeof(out)];
+
+        /* touched in-place, virtual interface; no slave response */
+        memcpy(in, out, sizeof(in));
+        ow.clear(0xffffffffUL);
+        owng.touchBytes(in, sizeof(in));
+        assert(!memcmp(in, out, sizeof(in)));
+
+        ow.clear(0x5a5a5a5aUL);
+        owng.readBytes(in, 3);
+        assert(in[0] == 0x5a && in[1] == 0x5a && in[2] == 0x5a);
+
+        /* number of sampled bits */
+        ow.clear(0);
+        owng.writeBytes(out, sizeof(out));
+        size_t smpl = 0;
+        for (size_t i = 0; i < ow._tlen; i++)
+            if (ow._trace[i] == 'S') smpl++;
+        assert(smpl == 8 + 2 + 3 + 4);
+
+        TEST_SUCCESS();
+    }
+
+    /*
+     * Powered bus is unpowered before touching, once per call.
+     */
+    static void test_powerBus()
+    {
+        OneWireNg_BitBang_Test ow;
+        uint8_t buf[4] = { 0xff, 0xff, 0xff, 0xff };
+
+        ow.clear(0);
+        assert(ow.powerBus(true) == EC_SUCCESS);
+        assert(ow._tlen == 1 && ow._trace[0] == 'P');
+
+        ow.touchBytes(buf, sizeof(buf));
+        assert(!ow._flgs.pwre);
+        assert(ow._tlen == 2 + 4*8*3 && ow._trace[1] == 'H');
+
+        TEST_SUCCESS();
+    }
+
+    /*
+     * Template based and virtual GPIO interfaces shall produce the same bus
+     * activity.
+     */
+    static void test_bitBangT()
+    {
+        OneWireNg_BitBang_Test ow1;
+        OneWireNg_BitBangT_Test ow2;
+        uint8_t buf1[] = { 0x00, 0xff, 0x55, 0x96 }, buf2[sizeof(buf1)];
+        memcpy(buf2, buf1, sizeof(buf1));
+
+        for (int od = 0; od < 2; od++)
+        {
+            ow1.setOverdrive(od != 0);
+            ow2.setOverdrive(od != 0);
+
+            ow1.clear(0x12345678UL);
+            ow2.clear(0x12345678UL);
+            assert(ow1.reset() == ow2.reset());
+            ow1.touchBytes(buf1, sizeof(buf1));
+            ow2.touchBytes(buf2, sizeof(buf2));
+            assert(ow1.touchBit(1) == ow2.touchBit(1));
+            assert(ow1.powerBus(true) == EC_SUCCESS &&
+                ow2.powerBus(true) == EC_SUCCESS);
+            assert(ow1.readByte() == ow2.readByte());
+
+            assert(!memcmp(buf1, buf2, sizeof(buf1)));
+            assert((GpioTrace&)ow1 == (GpioTrace&)ow2);
+        }
+
+        TEST_SUCCESS();
+    }
 };
 
 int main(void)
 {
+    OneWireNg_BitBang_Test::test_touchByte();
+    OneWireNg_BitBang_Test::test_touchBytes();
+    OneWireNg_BitBang_Test::test_powerBus();
+    OneWireNg_BitBang_Test::test_bitBangT();
+    OneWireNg_BitBangMultiT_Test::test_multiReset();
+    OneWireNg_BitBangMultiT_Test::test_multiTouch();
+    OneWireNg_BitBangMultiT_Test::test_multiPowerBus();
+
     return 0;
 }
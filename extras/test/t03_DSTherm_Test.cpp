@@ -145,6 +145,67 @@ public:
         TEST_SUCCESS();
     }
 
+    static void test_scratchpadTempFixed()
+    {
+        DSTherm_Test ow = DSTherm_Test();
+        OneWireNg::Id id = {};
+        uint8_t scrpd_raw[DSTherm::Scratchpad::LENGTH] = {};
+        DSTherm::Scratchpad scrpd = DSTherm::Scratchpad(ow, id, scrpd_raw);
+
+        /* DS18B20 */
+        scrpd._id[0] = DSTherm::DS18B20;
+        scrpd.setResolution(DSTherm::RES_12_BIT);
+
+        scrpd._scrpd[0] = 0xd0; scrpd._scrpd[1] = 0x07;
+        assert(scrpd.getTempQ8() == 125*256 && scrpd.getTempCenti() == 12500);
+        scrpd._scrpd[0] = 0x91; scrpd._scrpd[1] = 0x01;
+        assert(scrpd.getTempQ8() == 0x1910 && scrpd.getTempCenti() == 2506);
+        scrpd._scrpd[0] = 0x6f; scrpd._scrpd[1] = 0xfe;
+        assert(scrpd.getTempQ8() == -0x1910 && scrpd.getTempCenti() == -2506);
+        scrpd._scrpd[0] = 0x90; scrpd._scrpd[1] = 0xfc;
+        assert(scrpd.getTempQ8() == -55*256 && scrpd.getTempCenti() == -5500);
+
+        /* consistent with the generic decoding for all resolutions */
+        for (int res = DSTherm::RES_9_BIT; res <= DSTherm::RES_12_BIT; res++)
+        {
+            scrpd.setResolution((DSTherm::Resolution)res);
+            for (long raw = -55*16; raw <= 125*16; raw++) {
+                scrpd._scrpd[0] = (uint8_t)raw;
+                scrpd._scrpd[1] = (uint8_t)(raw >> 8);
+
+                long temp = scrpd.getTemp();
+                assert((long)scrpd.getTempQ8() * 1000 / 256 == temp);
+                assert(scrpd.getTempCenti() == temp / 10);
+            }
+        }
+
+        /* DS18S20 */
+        scrpd._id[0] = DSTherm::DS18S20;
+
+        for (long raw = -55*2; raw <= 125*2; raw++) {
+            scrpd._scrpd[0] = (uint8_t)raw;
+            scrpd._scrpd[1] = (uint8_t)(raw >> 8);
+
+            long temp = scrpd.getTemp();
+            assert((long)scrpd.getTempQ8() * 1000 / 256 == temp);
+            assert(scrpd.getTempCenti() == temp / 10);
+        }
+
+        /* batch decoding */
+        OneWireNg::Id ids[2] = {{DSTherm::DS18B20}, {DSTherm::DS18S20}};
+        uint8_t scrpds[2][DSTherm::Scratchpad::LENGTH] = {
+            {0x5e, 0xff, 0, 0, 0x7f}, {0x32, 0x00}
+        };
+        int16_t temps[2];
+
+        DSTherm::decodeTempQ8(ids, scrpds[0], 2, temps);
+        assert(temps[0] == -0x0a20 && temps[1] == 25*256);
+        DSTherm::decodeTempCenti(ids, scrpds[0], 2, temps);
+        assert(temps[0] == -1012 && temps[1] == 2500);
+
+        TEST_SUCCESS();
+    }
+
     static void test_scratchpadConfig()
     {
         DSTherm_Test ow = DSTherm_Test();
@@ -215,6 +276,7 @@ int main(void)
     DSTherm_Test::test_filterSupportedSlaves();
     DSTherm_Test::test_conversionTime();
     DSTherm_Test::test_scratchpadTemp();
+    DSTherm_Test::test_scratchpadTempFixed();
     DSTherm_Test::test_scratchpadConfig();
 
     return 0;
@@ -0,0 +1,869 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include "common.h"
+#include "OneWireNg_Simulated.h"
+#include "OneWireNg_Timings.h"
+#include "drivers/DSTherm.h"
+#include "platform/Platform_Delay.h"
+
+#define N_THERMS 20
+
+class OneWireNg_Simulated_Test
+{
+public:
+    static void test_slots()
+    {
+        OneWireNg_Simulated ow;
+
+        /* no devices */
+        assert(ow.reset() == OneWireNg::EC_NO_DEVS);
+        assert(ow.getStats().std.reset == 1 &&
+            ow.getTime() == STD_RESET_TIME);
+
+        OneWireNg::Id id;
+        OneWireNg_Simulated::Slave::makeId(id, DSTherm::DS18B20, 1);
+        assert(OneWireNg::checkCrcId(id) == OneWireNg::EC_SUCCESS);
+
+        OneWireNg_Simulated::DSThermSlave s(id);
+        ow.attach(s);
+        ow.resetStats();
+
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        ow.writeByte(0x0f);
+        ow.readBit();
+
+        const OneWireNg_Simulated::Stats& st = ow.getStats();
+        assert(st.std.reset == 1 && st.std.write0 == 4 && st.std.write1 == 5);
+        assert(st.busTime ==
+            STD_RESET_TIME + 4*STD_WRITE0_TIME + 5*STD_WRITE1_TIME);
+
+        unsigned long t = ow.getTime();
+        ow.advanceTime(1000);
+        assert(ow.getTime() == t + 1000 && st.busTime < ow.getTime());
+
+        TEST_SUCCESS();
+    }
+
+    static void test_delayBus()
+    {
+        OneWireNg_Simulated ow1;
+
+        /* single bus: implicit delay target */
+        unsigned long t = ow1.getTime();
+        delayMs(10);
+        assert(ow1.getTime() == t + 10000);
+
+        /* several buses: delay target set explicitly */
+        OneWireNg_Simulated ow2;
+        OneWireNg_Simulated::setDelayBus(&ow2);
+        t = ow2.getTime();
+        unsigned long t1 = ow1.getTime();
+        delayUs(100);
+        assert(ow2.getTime() == t + 100 && ow1.getTime() == t1);
+
+        OneWireNg_Simulated::setDelayBus(&ow1);
+        delayUs(100);
+        assert(ow2.getTime() == t + 100 && ow1.getTime() == t1 + 100);
+        OneWireNg_Simulated::setDelayBus(NULL);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_readRom()
+    {
+        OneWireNg_Simulated ow;
+        OneWireNg::Id id, rid;
+
+        OneWireNg_Simulated::Slave::makeId(id, DSTherm::DS18B20, 0x123456);
+        OneWireNg_Simulated::DSThermSlave s1(id);
+        ow.attach(s1);
+
+        assert(ow.readSingleId(rid) == OneWireNg::EC_SUCCESS &&
+            !memcmp(id, rid, sizeof(id)));
+
+        /* more slaves - garbage */
+        OneWireNg_Simulated::Slave::makeId(id, DSTherm::DS18B20, 0x654321);
+        OneWireNg_Simulated::DSThermSlave s2(id);
+        ow.attach(s2);
+        assert(ow.readSingleId(rid) == OneWireNg::EC_CRC_ERROR);
+
+        ow.detach(s1);
+        assert(ow.readSingleId(rid) == OneWireNg::EC_SUCCESS &&
+            !memcmp(id, rid, sizeof(id)));
+
+        TEST_SUCCESS();
+    }
+
+    static void test_search()
+    {
+        OneWireNg_Simulated ow;
+        OneWireNg::Id ids[N_THERMS];
+        uint8_t buf[N_THERMS * sizeof(OneWireNg_Simulated::DSThermSlave)];
+        OneWireNg_Simulated::DSThermSlave *s =
+            reinterpret_cast<OneWireNg_Simulated::DSThermSlave*>(buf);
+
+        for (int i = 0; i < N_THERMS; i++) {
+            OneWireNg_Simulated::Slave::makeId(
+                ids[i], DSTherm::DS18B20, 0x1000UL * (i + 1) + 7 * i);
+            new (&s[i]) OneWireNg_Simulated::DSThermSlave(ids[i]);
+            ow.attach(s[i]);
+        }
+
+        OneWireNg::Id id;
+        OneWireNg::ErrorCode ec;
+        int fnd[N_THERMS] = {};
+
+        do {
+            ec = ow.search(id);
+            assert(ec == OneWireNg::EC_MORE || ec == OneWireNg::EC_DONE);
+
+            for (int i = 0; i < N_THERMS; i++) {
+                if (!memcmp(id, ids[i], sizeof(id))) {
+                    fnd[i]++;
+                    break;
+                }
+            }
+        } while (ec == OneWireNg::EC_MORE);
+
+        for (int i = 0; i < N_THERMS; i++)
+            assert(fnd[i] == 1);
+
+        /* each search step: reset + command + 64 triplets */
+        const OneWireNg_Simulated::Stats& st = ow.getStats();
+        assert(st.std.reset == N_THERMS);
+        assert(st.std.write0 + st.std.write1 == N_THERMS * (8 + 3*64));
+
+        ow.detachAll();
+        TEST_SUCCESS();
+    }
+
+    static void test_dstherm()
+    {
+        OneWireNg_Simulated ow;
+        DSTherm dsth(ow);
+        OneWireNg::Id id1, id2;
+
+        OneWireNg_Simulated::Slave::makeId(id1, DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::Slave::makeId(id2, DSTherm::DS18S20, 2);
+        OneWireNg_Simulated::DSThermSlave s1(id1), s2(id2);
+        ow.attach(s1);
+        ow.attach(s2);
+
+        MAKE_SCRATCHPAD(scrpd);
+
+        /* power-up value */
+        assert(dsth.readScratchpad(id1, scrpd) == OneWireNg::EC_SUCCESS);
+        assert(scrpd->getTemp() == 85000 &&
+            scrpd->getResolution() == DSTherm::RES_12_BIT);
+
+        s1.setTemp(-10125);
+        s2.setTemp(25000);
+
+        /* the bus is scanned for completion; virtual clock is advanced */
+        unsigned long t = ow.getTime();
+        assert(dsth.convertTempAll() == OneWireNg::EC_SUCCESS);
+        assert(ow.getTime() - t >= 750000 && ow.getTime() - t < 760000);
+
+        assert(dsth.readScratchpad(id1, scrpd) == OneWireNg::EC_SUCCESS);
+        assert(scrpd->getTemp() == -10125);
+        assert(dsth.readScratchpad(id2, scrpd) == OneWireNg::EC_SUCCESS);
+        assert(scrpd->getTemp() == 25000);
+
+        /* change resolution; conversion time scales accordingly */
+        assert(dsth.writeScratchpad(id1, 30, -30, DSTherm::RES_9_BIT) ==
+            OneWireNg::EC_SUCCESS);
+        assert(dsth.readScratchpad(id1, scrpd) == OneWireNg::EC_SUCCESS);
+        assert(scrpd->getTh() == 30 && scrpd->getTl() == -30 &&
+            scrpd->getResolution() == DSTherm::RES_9_BIT);
+        assert(s1.getConversionTime() == 93750);
+
+        t = ow.getTime();
+        assert(dsth.convertTemp(id1) == OneWireNg::EC_SUCCESS);
+        assert(ow.getTime() - t >= 93750 && ow.getTime() - t < 110000);
+
+        assert(dsth.readScratchpad(id1, scrpd) == OneWireNg::EC_SUCCESS);
+        assert(scrpd->getTemp() == -10500);
+
+        /* EEPROM */
+        assert(dsth.copyScratchpad(id1) == OneWireNg::EC_SUCCESS);
+        assert(s1.getEeprom()[0] == 30 && (int8_t)s1.getEeprom()[1] == -30);
+
+        /* power supply */
+        assert(dsth.readPowerSupplyAll() == 1);
+
+        OneWireNg::Id id3;
+        OneWireNg_Simulated::Slave::makeId(id3, DSTherm::DS18B20, 3);
+        OneWireNg_Simulated::DSThermSlave s3(id3, true);
+        ow.attach(s3);
+        assert(dsth.readPowerSupplyAll() == 0);
+        assert(dsth.readPowerSupply(id1) == 1);
+        assert(dsth.readPowerSupply(id3) == 0);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_dsthermAsync()
+    {
+        OneWireNg_Simulated ow;
+        DSTherm dsth(ow);
+        OneWireNg::Id id1, id2;
+
+        OneWireNg_Simulated::Slave::makeId(id1, DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::Slave::makeId(id2, DSTherm::DS18B20, 2);
+        OneWireNg_Simulated::DSThermSlave s1(id1), s2(id2);
+        ow.attach(s1);
+        ow.attach(s2);
+        s1.setTemp(21500);
+        s2.setTemp(-5000);
+
+        MAKE_SCRATCHPAD(scrpd);
+        unsigned long left;
+
+        /* no conversion in progress */
+        assert(dsth.pollConvert(0, &left) == OneWireNg::EC_SUCCESS && !left);
+
+        /* scheduled by time; the bus is not read while polling */
+        unsigned long t0 = ow.getTime() / 1000;
+        assert(dsth.startConvertTempAll(t0, DSTherm::MAX_CONV_TIME) ==
+            OneWireNg::EC_SUCCESS);
+        assert(ow.getTime() / 1000 - t0 < 5);
+
+        ow.resetStats();
+        assert(dsth.pollConvert(t0 + 100, &left) == OneWireNg::EC_MORE &&
+            left == 650);
+        assert(dsth.collect(id1, scrpd) == OneWireNg::EC_MORE);
+        assert(dsth.pollConvert(t0 + 749) == OneWireNg::EC_MORE);
+        assert(!ow.getStats().std.write1 && !ow.getStats().std.reset);
+
+        ow.advanceTime(750000);
+        assert(dsth.pollConvert(t0 + 750, &left) == OneWireNg::EC_SUCCESS &&
+            !left);
+        assert(dsth.collect(id1, scrpd) == OneWireNg::EC_SUCCESS &&
+            scrpd->getTemp() == 21500);
+        assert(dsth.collect(id2, scrpd) == OneWireNg::EC_SUCCESS &&
+            scrpd->getTemp() == -5000);
+
+        /* completion detected on the bus */
+        s1.setTemp(30000);
+        t0 = ow.getTime() / 1000;
+        assert(dsth.startConvertTemp(id1, t0) == OneWireNg::EC_SUCCESS);
+        assert(dsth.pollConvert(ow.getTime() / 1000) == OneWireNg::EC_MORE);
+
+        ow.advanceTime(760000);
+        assert(dsth.pollConvert(t0 + 10) == OneWireNg::EC_SUCCESS);
+        assert(dsth.collect(id1, scrpd) == OneWireNg::EC_SUCCESS &&
+            scrpd->getTemp() == 30000);
+
+        /* time wrap-around */
+        assert(dsth.startConvertTempAll(
+            (unsigned long)-100, 200, true) == OneWireNg::EC_SUCCESS);
+        assert(dsth.pollConvert(50, &left) == OneWireNg::EC_MORE && left == 50);
+        assert(dsth.pollConvert(100) == OneWireNg::EC_SUCCESS);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_dsthermSched()
+    {
+        OneWireNg_Simulated ow;
+        DSTherm dsth(ow);
+        DSTherm::SchedSensor snsrs[3];
+
+        OneWireNg_Simulated::Slave::makeId(snsrs[0].id, DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::Slave::makeId(snsrs[1].id, DSTherm::DS18S20, 2);
+        OneWireNg_Simulated::Slave::makeId(snsrs[2].id, DSTherm::DS1822, 3);
+        OneWireNg_Simulated::DSThermSlave
+            s1(snsrs[0].id), s2(snsrs[1].id), s3(snsrs[2].id);
+        ow.attach(s1);
+        ow.attach(s2);
+        ow.attach(s3);
+
+        assert(dsth.writeScratchpad(snsrs[0].id, 0, 0, DSTherm::RES_9_BIT) ==
+            OneWireNg::EC_SUCCESS);
+        assert(dsth.writeScratchpad(snsrs[2].id, 0, 0, DSTherm::RES_11_BIT) ==
+            OneWireNg::EC_SUCCESS);
+        snsrs[0].res = DSTherm::RES_9_BIT;
+        snsrs[1].res = DSTherm::RES_9_BIT;  /* DS18S20: always 750 ms */
+        snsrs[2].res = DSTherm::RES_11_BIT;
+
+        s1.setTemp(10000);
+        s2.setTemp(20000);
+        s3.setTemp(30000);
+
+        assert(DSTherm::getConversionTime(snsrs[0].id, snsrs[0].res) == 94);
+        assert(DSTherm::getConversionTime(snsrs[1].id, snsrs[1].res) == 750);
+        assert(DSTherm::getConversionTime(snsrs[2].id, snsrs[2].res) == 375);
+
+        unsigned long left;
+        unsigned long t0 = ow.getTime() / 1000;
+        assert(dsth.startConvertSched(snsrs, 3, t0) == OneWireNg::EC_SUCCESS);
+
+        assert(dsth.pollSched(t0 + 10, &left) == OneWireNg::EC_MORE &&
+            left == 84);
+        assert(snsrs[0].ec == OneWireNg::EC_MORE);
+
+        /* 9-bit sensor read while the others are still converting */
+        ow.advanceTime(94000);
+        assert(dsth.pollSched(t0 + 94, &left) == OneWireNg::EC_MORE &&
+            left == 375 - 94);
+        assert(snsrs[0].ec == OneWireNg::EC_SUCCESS && snsrs[0].temp == 10000);
+        assert(snsrs[1].ec == OneWireNg::EC_MORE &&
+            snsrs[2].ec == OneWireNg::EC_MORE);
+
+        ow.advanceTime(375000 - 94000);
+        assert(dsth.pollSched(t0 + 375, &left) == OneWireNg::EC_MORE &&
+            left == 750 - 375);
+        assert(snsrs[2].ec == OneWireNg::EC_SUCCESS && snsrs[2].temp == 30000);
+
+        ow.advanceTime(750000 - 375000);
+        assert(dsth.pollSched(t0 + 750, &left) == OneWireNg::EC_SUCCESS &&
+            !left);
+        assert(snsrs[1].ec == OneWireNg::EC_SUCCESS && snsrs[1].temp == 20000);
+
+        /* all sensors read once */
+        assert(dsth.pollSched(t0 + 1000) == OneWireNg::EC_SUCCESS);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_sampleAll()
+    {
+        OneWireNg_Simulated ow;
+        DSTherm dsth(ow);
+        OneWireNg::Id ids[4];
+        long temps[4];
+        OneWireNg::ErrorCode ecs[4];
+
+        OneWireNg_Simulated::Slave::makeId(ids[0], DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::Slave::makeId(ids[1], DSTherm::DS18S20, 2);
+        OneWireNg_Simulated::Slave::makeId(ids[2], DSTherm::DS1822, 3);
+        /* not connected */
+        OneWireNg_Simulated::Slave::makeId(ids[3], DSTherm::DS18B20, 4);
+
+        OneWireNg_Simulated::DSThermSlave s1(ids[0]), s2(ids[1]), s3(ids[2]);
+        ow.attach(s1);
+        ow.attach(s2);
+        ow.attach(s3);
+        s1.setTemp(-12500);
+        s2.setTemp(85500);
+        s3.setTemp(23000);
+
+        assert(dsth.sampleAll(ids, 3, temps) == OneWireNg::EC_SUCCESS);
+        assert(temps[0] == -12500 && temps[1] == 85500 && temps[2] == 23000);
+
+        /* truncated reads: match, command, 5 (2 for DS18S20) scratchpad bytes */
+        ow.resetStats();
+        assert(dsth.sampleAll(ids, 4, temps, ecs, false, 0) ==
+            OneWireNg::EC_BUS_ERROR);
+        assert(ecs[0] == OneWireNg::EC_SUCCESS &&
+            ecs[1] == OneWireNg::EC_SUCCESS &&
+            ecs[2] == OneWireNg::EC_SUCCESS &&
+            ecs[3] == OneWireNg::EC_BUS_ERROR);
+
+        const OneWireNg_Simulated::Stats& st = ow.getStats();
+        assert(st.std.reset == 1 + 2*4);
+        assert(st.std.write0 + st.std.write1 ==
+            8*(2 + 4*(1 + 8 + 1) + 5 + 2 + 5 + 5));
+
+        /* validated reads */
+        ow.resetStats();
+        assert(dsth.sampleAll(ids, 4, temps, ecs, true, 0) ==
+            OneWireNg::EC_CRC_ERROR);
+        assert(ecs[0] == OneWireNg::EC_SUCCESS &&
+            ecs[1] == OneWireNg::EC_SUCCESS &&
+            ecs[2] == OneWireNg::EC_SUCCESS &&
+            ecs[3] == OneWireNg::EC_CRC_ERROR);
+        assert(st.std.write0 + st.std.write1 == 8*(2 + 4*(1 + 8 + 1 + 9)));
+
+        /* no devices; all statuses written */
+        ow.detachAll();
+        ecs[0] = ecs[1] = ecs[2] = ecs[3] = OneWireNg::EC_SUCCESS;
+        assert(dsth.sampleAll(ids, 4, temps, ecs, false, 0) ==
+            OneWireNg::EC_NO_DEVS);
+        for (int i = 0; i < 4; i++)
+            assert(ecs[i] == OneWireNg::EC_NO_DEVS);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_readTemp()
+    {
+        OneWireNg_Simulated ow;
+        DSTherm dsth(ow);
+        OneWireNg::Id id1, id2;
+        long temp;
+
+        OneWireNg_Simulated::Slave::makeId(id1, DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::Slave::makeId(id2, DSTherm::DS18S20, 2);
+        OneWireNg_Simulated::DSThermSlave s1(id1), s2(id2);
+        ow.attach(s1);
+        ow.attach(s2);
+
+        assert(dsth.writeScratchpad(id1, 0, 0, DSTherm::RES_10_BIT) ==
+            OneWireNg::EC_SUCCESS);
+        s1.setTemp(-3250);
+        s2.setTemp(12500);
+        assert(dsth.convertTempAll() == OneWireNg::EC_SUCCESS);
+
+        /* match + command + bytes read; terminated by reset */
+        const OneWireNg_Simulated::Stats& st = ow.getStats();
+        ow.resetStats();
+        assert(dsth.readTemp(id1, &temp) == OneWireNg::EC_SUCCESS &&
+            temp == -3250);
+        assert(st.std.write0 + st.std.write1 == 8*(1 + 8 + 1 + 5));
+        assert(st.std.reset == 2);
+
+        /* the sensor doesn't transmit the rest of the scratchpad */
+        uint8_t rest[DSTherm::Scratchpad::LENGTH - 5];
+        ow.readBytes(rest, sizeof(rest));
+        for (size_t i = 0; i < sizeof(rest); i++)
+            assert(rest[i] == 0xff);
+
+        ow.resetStats();
+        assert(dsth.readTemp(id1, DSTherm::RES_10_BIT, &temp) ==
+            OneWireNg::EC_SUCCESS && temp == -3250);
+        assert(st.std.write0 + st.std.write1 == 8*(1 + 8 + 1 + 2));
+
+        ow.resetStats();
+        assert(dsth.readTemp(id2, &temp) == OneWireNg::EC_SUCCESS &&
+            temp == 12500);
+        assert(st.std.write0 + st.std.write1 == 8*(1 + 8 + 1 + 2));
+
+        /* each 3rd read is the full one */
+        dsth.setFullReadPeriod(3);
+        ow.resetStats();
+        for (int i = 0; i < 6; i++) {
+            assert(dsth.readTemp(id1, DSTherm::RES_10_BIT, &temp) ==
+                OneWireNg::EC_SUCCESS && temp == -3250);
+        }
+        assert(st.std.write0 + st.std.write1 ==
+            8*(6*(1 + 8 + 1) + 4*2 + 2*9));
+
+        /* temperature read as all ones is validated by the full read */
+        dsth.setFullReadPeriod(0);
+        assert(dsth.writeScratchpad(id1, 0, 0, DSTherm::RES_12_BIT) ==
+            OneWireNg::EC_SUCCESS);
+        s1.setTemp(-62);
+        assert(dsth.convertTempAll() == OneWireNg::EC_SUCCESS);
+        ow.resetStats();
+        assert(dsth.readTemp(id1, DSTherm::RES_12_BIT, &temp) ==
+            OneWireNg::EC_SUCCESS && temp == -62);
+        assert(st.std.write0 + st.std.write1 == 8*(2*(1 + 8 + 1) + 2 + 9));
+
+        /* not connected sensor */
+        OneWireNg_Simulated::Slave::makeId(id1, DSTherm::DS18B20, 3);
+        assert(dsth.readTemp(id1, &temp) == OneWireNg::EC_BUS_ERROR);
+        assert(dsth.readTemp(id1, DSTherm::RES_12_BIT, &temp) ==
+            OneWireNg::EC_CRC_ERROR);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_convPolling()
+    {
+        OneWireNg_Simulated ow;
+        DSTherm dsth(ow);
+        OneWireNg::Id ids[6];
+        OneWireNg_Simulated::DSThermSlave *slaves[TAB_SZ(ids)];
+        DSTherm::ConvEst est[TAB_SZ(ids)];
+
+        for (size_t i = 0; i < TAB_SZ(ids); i++) {
+            OneWireNg_Simulated::Slave::makeId(ids[i], DSTherm::DS18B20, i + 1);
+            slaves[i] = new OneWireNg_Simulated::DSThermSlave(ids[i]);
+            ow.attach(*slaves[i]);
+        }
+
+        const OneWireNg_Simulated::Stats& st = ow.getStats();
+        unsigned long t, polls;
+
+        /* no learning table: nominal time of 12-bits resolution is awaited */
+        for (int i = 0; i < 2; i++) {
+            ow.resetStats();
+            t = ow.getTime();
+            assert(dsth.convertTemp(ids[0]) == OneWireNg::EC_SUCCESS);
+            assert(ow.getTime() - t >= 750000 && ow.getTime() - t < 760000);
+            /* match + command + single poll */
+            assert(st.std.write0 + st.std.write1 == 8*(1 + 8 + 1) + 1);
+        }
+
+        /*
+         * Round-robin conversions: after the 1st one (nominal time) the bus
+         * is polled after 7/8 of the learned time of each sensor.
+         */
+        dsth.setConvEstTable(est, TAB_SZ(est));
+        for (int r = 0; r < 3; r++) {
+            for (size_t i = 0; i < TAB_SZ(ids); i++) {
+                ow.resetStats();
+                t = ow.getTime();
+                assert(dsth.convertTemp(ids[i]) == OneWireNg::EC_SUCCESS);
+                assert(ow.getTime() - t >= 750000 &&
+                    ow.getTime() - t < 760000);
+                polls = st.std.write0 + st.std.write1 - 8*(1 + 8 + 1);
+                assert(r ? (polls > 1 && polls < 20) : polls == 1);
+            }
+        }
+
+        /*
+         * Resolution change: nominal time of the new resolution is awaited,
+         * also for sensors with learned times replaced in the table smaller
+         * than the number of sensors.
+         */
+        for (size_t i = 0; i < TAB_SZ(ids); i++) {
+            assert(dsth.writeScratchpad(ids[i], 0, 0, DSTherm::RES_9_BIT) ==
+                OneWireNg::EC_SUCCESS);
+        }
+        dsth.setConvEstTable(est, 2);
+        for (int r = 0; r < 2; r++) {
+            for (size_t i = 0; i < TAB_SZ(ids); i++) {
+                ow.resetStats();
+                t = ow.getTime();
+                assert(dsth.convertTemp(ids[i]) == OneWireNg::EC_SUCCESS);
+                assert(ow.getTime() - t >= 93750 && ow.getTime() - t < 110000);
+                assert(st.std.write0 + st.std.write1 == 8*(1 + 8 + 1) + 1);
+            }
+        }
+
+        /*
+         * The learned time is not shared with other sensor of the same
+         * family and id CRC (configured to 12-bits resolution).
+         */
+        dsth.setConvEstTable(est, TAB_SZ(est));
+        assert(dsth.convertTemp(ids[0]) == OneWireNg::EC_SUCCESS);
+
+        OneWireNg::Id id2;
+        unsigned long sn = 100;
+        do {
+            OneWireNg_Simulated::Slave::makeId(id2, DSTherm::DS18B20, sn++);
+        } while (id2[sizeof(id2) - 1] != ids[0][sizeof(id2) - 1]);
+
+        OneWireNg_Simulated::DSThermSlave s2(id2);
+        ow.attach(s2);
+        assert(dsth.writeScratchpad(id2, 0, 0, DSTherm::RES_12_BIT) ==
+            OneWireNg::EC_SUCCESS);
+        ow.resetStats();
+        t = ow.getTime();
+        assert(dsth.convertTemp(id2) == OneWireNg::EC_SUCCESS);
+        assert(ow.getTime() - t >= 750000 && ow.getTime() - t < 760000);
+        assert(st.std.write0 + st.std.write1 == 8*(1 + 8 + 1) + 1);
+
+        /* the sensor's learned time is still used */
+        ow.resetStats();
+        t = ow.getTime();
+        assert(dsth.convertTemp(ids[0]) == OneWireNg::EC_SUCCESS);
+        assert(ow.getTime() - t >= 93750 && ow.getTime() - t < 110000);
+        polls = st.std.write0 + st.std.write1 - 8*(1 + 8 + 1);
+        assert(polls > 1 && polls < 20);
+
+        ow.detachAll();
+        for (size_t i = 0; i < TAB_SZ(ids); i++)
+            delete slaves[i];
+
+        TEST_SUCCESS();
+    }
+
+    static void test_scratchpadView()
+    {
+        OneWireNg_Simulated ow;
+        DSTherm dsth(ow);
+        OneWireNg::Id ids[2];
+
+        OneWireNg_Simulated::Slave::makeId(ids[0], DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::Slave::makeId(ids[1], DSTherm::DS18S20, 2);
+        OneWireNg_Simulated::DSThermSlave s1(ids[0]), s2(ids[1]);
+        ow.attach(s1);
+        ow.attach(s2);
+
+        s1.setTemp(-10125);
+        s2.setTemp(25000);
+        assert(dsth.convertTempAll() == OneWireNg::EC_SUCCESS);
+
+        /* raw scratchpads of all sensors decoded in-place */
+        uint8_t scrpds[2][DSTherm::Scratchpad::LENGTH];
+        for (int i = 0; i < 2; i++) {
+            assert(dsth.readScratchpad(ids[i], scrpds[i]) ==
+                OneWireNg::EC_SUCCESS);
+        }
+
+        DSTherm::ScratchpadView v1(ids[0], scrpds[0]), v2(ids[1], scrpds[1]);
+        assert(&v1.getId() == &ids[0] && v1.getRaw() == scrpds[0]);
+        assert(v1.getTemp() == -10125 && v1.getTempCenti() == -1012 &&
+            v1.getResolution() == DSTherm::RES_12_BIT);
+        assert(v2.getTemp() == 25000 && v2.getTempQ8() == 25*256 &&
+            v2.getResolution() == DSTherm::RES_9_BIT);
+
+        /* modify configuration via the view */
+        v1.setThl(40, -20);
+        v1.setResolution(DSTherm::RES_10_BIT);
+        assert(OneWireNg::crc8(scrpds[0], DSTherm::Scratchpad::LENGTH) == 0);
+        assert(dsth.writeScratchpad(v1) == OneWireNg::EC_SUCCESS);
+
+        MAKE_SCRATCHPAD(scrpd);
+        assert(dsth.readScratchpad(ids[0], scrpd) == OneWireNg::EC_SUCCESS);
+        assert(scrpd->getTh() == 40 && scrpd->getTl() == -20 &&
+            scrpd->getResolution() == DSTherm::RES_10_BIT);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_alarmSearch()
+    {
+        OneWireNg_Simulated ow;
+        DSTherm dsth(ow);
+        OneWireNg::Id id1, id2, id;
+
+        OneWireNg_Simulated::Slave::makeId(id1, DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::Slave::makeId(id2, DSTherm::DS18B20, 2);
+        OneWireNg_Simulated::DSThermSlave s1(id1), s2(id2);
+        ow.attach(s1);
+        ow.attach(s2);
+
+        dsth.writeScratchpadAll(50, -10);
+        s1.setTemp(20000);
+        s2.setTemp(60000);
+        dsth.convertTempAll();
+
+        assert(ow.search(id, true) == OneWireNg::EC_DONE);
+        assert(!memcmp(id, id2, sizeof(id)));
+
+        TEST_SUCCESS();
+    }
+
+    static void test_sampleAlarms()
+    {
+        OneWireNg_Simulated ow;
+        DSTherm dsth(ow);
+        OneWireNg::Id ids[12], aids[4];
+        OneWireNg_Simulated::DSThermSlave *s[12];
+        long temps[4];
+        OneWireNg::ErrorCode ecs[4];
+        size_t found;
+
+        for (int i = 0; i < 12; i++) {
+            OneWireNg_Simulated::Slave::makeId(ids[i], DSTherm::DS18B20, i+1);
+            s[i] = new OneWireNg_Simulated::DSThermSlave(ids[i]);
+            ow.attach(*s[i]);
+            s[i]->setTemp(20000 + 1000*(i % 6));
+        }
+
+        /* no alarms */
+        assert(dsth.writeScratchpadAll(50, -10) == OneWireNg::EC_SUCCESS);
+        assert(dsth.sampleAlarms(aids, TAB_SZ(aids), &found, temps) ==
+            OneWireNg::EC_SUCCESS && found == 0);
+
+        /* per sensor alarm triggers */
+        assert(dsth.writeScratchpad(ids[1], 21, -10) == OneWireNg::EC_SUCCESS);
+        assert(dsth.writeScratchpad(ids[4], 50, 25) == OneWireNg::EC_SUCCESS);
+
+        const OneWireNg_Simulated::Stats& st = ow.getStats();
+        ow.resetStats();
+        assert(dsth.sampleAlarms(aids, TAB_SZ(aids), &found, temps, ecs) ==
+            OneWireNg::EC_SUCCESS && found == 2);
+        unsigned long slots = st.std.write0 + st.std.write1;
+
+        for (size_t i = 0; i < found; i++) {
+            assert(ecs[i] == OneWireNg::EC_SUCCESS);
+            if (!memcmp(aids[i], ids[1], sizeof(OneWireNg::Id))) {
+                assert(temps[i] == 21000);
+            } else {
+                assert(!memcmp(aids[i], ids[4], sizeof(OneWireNg::Id)) &&
+                    temps[i] == 24000);
+            }
+        }
+
+        /* less bus traffic than the whole bus sweep */
+        long all[12];
+        ow.resetStats();
+        assert(dsth.sampleAll(ids, 12, all) == OneWireNg::EC_SUCCESS);
+        assert(slots < st.std.write0 + st.std.write1);
+
+        /* alarms table full */
+        assert(dsth.sampleAlarms(aids, 1, &found, temps) ==
+            OneWireNg::EC_FULL && found == 1);
+
+        /* number of alarms not needed */
+        assert(dsth.sampleAlarms(aids, TAB_SZ(aids), NULL, temps) ==
+            OneWireNg::EC_SUCCESS);
+
+        ow.detachAll();
+        for (int i = 0; i < 12; i++)
+            delete s[i];
+
+        assert(dsth.sampleAlarms(aids, TAB_SZ(aids), &found, temps) ==
+            OneWireNg::EC_NO_DEVS && found == 0);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_writeConfig()
+    {
+        OneWireNg_Simulated ow;
+        DSTherm dsth(ow);
+        OneWireNg_Simulated::DSThermSlave *s[8];
+        DSTherm::SensorConfig cfgs[8];
+
+        for (int i = 0; i < 8; i++) {
+            OneWireNg_Simulated::Slave::makeId(cfgs[i].id,
+                (i == 7 ? DSTherm::DS18S20 : DSTherm::DS18B20), i+1);
+            s[i] = new OneWireNg_Simulated::DSThermSlave(cfgs[i].id);
+            ow.attach(*s[i]);
+
+            cfgs[i].th = 40;
+            cfgs[i].tl = -5;
+            cfgs[i].res = DSTherm::RES_10_BIT;
+        }
+
+        /* outliers */
+        cfgs[2].res = DSTherm::RES_12_BIT;
+        cfgs[5].th = 30;
+        /* DS18S20: resolution ignored */
+        cfgs[7].res = DSTherm::RES_9_BIT;
+
+        /* broadcast + 2 outliers + copy */
+        const OneWireNg_Simulated::Stats& st = ow.getStats();
+        ow.resetStats();
+        assert(dsth.writeConfigAll(cfgs, 8, true) == OneWireNg::EC_SUCCESS);
+        assert(st.std.reset == 4);
+
+        for (int i = 0; i < 8; i++) {
+            const uint8_t *scrpd = s[i]->getScratchpad();
+            assert((int8_t)scrpd[2] == cfgs[i].th &&
+                (int8_t)scrpd[3] == cfgs[i].tl);
+            assert(!memcmp(s[i]->getEeprom(), &scrpd[2], 2));
+            if (i != 7) {
+                assert((DSTherm::Resolution)((scrpd[4] >> 5) & 3) ==
+                    cfgs[i].res);
+            }
+        }
+
+        /* subset of sensors: addressed individually, others not affected */
+        cfgs[0].th = 1;
+        cfgs[1].th = 1;
+        ow.resetStats();
+        assert(dsth.writeConfig(cfgs, 2, true) == OneWireNg::EC_SUCCESS);
+        assert(st.std.reset == 2 + 2);
+        for (int i = 0; i < 8; i++) {
+            assert(s[i]->getScratchpad()[2] == (i < 2 ? 1 : cfgs[i].th) &&
+                s[i]->getEeprom()[0] == (i < 2 ? 1 : cfgs[i].th));
+        }
+
+        /* broadcast + 1 outlier */
+        ow.resetStats();
+        assert(dsth.writeConfigAll(cfgs + 5, 3) == OneWireNg::EC_SUCCESS);
+        assert(st.std.reset == 2);
+
+        ow.detachAll();
+        for (int i = 0; i < 8; i++)
+            delete s[i];
+
+        assert(dsth.writeConfig(cfgs, 8) == OneWireNg::EC_NO_DEVS);
+        assert(dsth.writeConfigAll(cfgs, 8) == OneWireNg::EC_NO_DEVS);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_ds2431()
+    {
+        OneWireNg_Simulated ow;
+        OneWireNg::Id id1, id2;
+
+        OneWireNg_Simulated::Slave::makeId(id1, 0x2d, 1);
+        OneWireNg_Simulated::Slave::makeId(id2, DSTherm::DS18B20, 2);
+        OneWireNg_Simulated::DS2431Slave s1(id1);
+        OneWireNg_Simulated::DSThermSlave s2(id2);
+        ow.attach(s1);
+        ow.attach(s2);
+
+        const uint8_t row[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+        uint8_t cmd[16];
+
+        /* write scratchpad */
+        cmd[0] = 0x0f;
+        cmd[1] = 0x08;
+        cmd[2] = 0x00;
+        memcpy(&cmd[3], row, sizeof(row));
+        cmd[11] = cmd[12] = 0xff;
+
+        assert(ow.addressSingle(id1) == OneWireNg::EC_SUCCESS);
+        ow.touchBytes(cmd, 13);
+        assert(OneWireNg::checkInvCrc16(
+            cmd, 11, OneWireNg::getLSB_u16(&cmd[11])) == OneWireNg::EC_SUCCESS);
+
+        /* read scratchpad (resume) */
+        cmd[0] = 0xaa;
+        memset(&cmd[1], 0xff, 13);
+
+        assert(ow.resume() == OneWireNg::EC_SUCCESS);
+        ow.touchBytes(cmd, 14);
+        assert(OneWireNg::checkInvCrc16(
+            cmd, 12, OneWireNg::getLSB_u16(&cmd[12])) == OneWireNg::EC_SUCCESS);
+        assert(cmd[1] == 0x08 && cmd[2] == 0x00 && cmd[3] == 0x07 &&
+            !memcmp(&cmd[4], row, sizeof(row)));
+
+        /* copy scratchpad */
+        cmd[0] = 0x55;
+        assert(ow.resume() == OneWireNg::EC_SUCCESS);
+        ow.writeBytes(cmd, 4);
+        ow.advanceTime(10000);
+        assert(ow.readByte() == 0xaa);
+        assert(!memcmp(&s1.getMemory()[8], row, sizeof(row)));
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+        /* read memory in overdrive mode */
+        uint8_t mem[2 + 8 + 1];
+        mem[0] = 0x06;
+        mem[1] = 0x00;
+        memset(&mem[2], 0xff, 9);
+
+        ow.resetStats();
+        assert(ow.overdriveSingle(id1) == OneWireNg::EC_SUCCESS);
+        ow.writeByte(0xf0);
+        ow.touchBytes(mem, sizeof(mem));
+        assert(mem[2] == 0xff && mem[3] == 0xff &&
+            !memcmp(&mem[4], row, 6));
+        assert(ow.getStats().od.write0 + ow.getStats().od.write1 ==
+            8*(sizeof(OneWireNg::Id) + 1 + sizeof(mem)));
+
+        /* thermometer doesn't support overdrive */
+        assert(ow.overdriveAll() == OneWireNg::EC_SUCCESS);
+        OneWireNg::Id id;
+        assert(ow.search(id) == OneWireNg::EC_DONE &&
+            !memcmp(id, id1, sizeof(id)));
+
+        ow.setOverdrive(false);
+        ow.searchReset();
+        assert(ow.search(id) == OneWireNg::EC_MORE);
+#endif
+        TEST_SUCCESS();
+    }
+};
+
+int main(void)
+{
+    OneWireNg_Simulated_Test::test_slots();
+    OneWireNg_Simulated_Test::test_delayBus();
+    OneWireNg_Simulated_Test::test_readRom();
+    OneWireNg_Simulated_Test::test_search();
+    OneWireNg_Simulated_Test::test_dstherm();
+    OneWireNg_Simulated_Test::test_dsthermAsync();
+    OneWireNg_Simulated_Test::test_dsthermSched();
+    OneWireNg_Simulated_Test::test_sampleAll();
+    OneWireNg_Simulated_Test::test_readTemp();
+    OneWireNg_Simulated_Test::test_convPolling();
+    OneWireNg_Simulated_Test::test_scratchpadView();
+    OneWireNg_Simulated_Test::test_alarmSearch();
+    OneWireNg_Simulated_Test::test_sampleAlarms();
+    OneWireNg_Simulated_Test::test_writeConfig();
+    OneWireNg_Simulated_Test::test_ds2431();
+
+    return 0;
+}
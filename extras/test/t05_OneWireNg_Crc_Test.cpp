@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/*
+ * The test is built for each of the CRC algorithms (see Makefile) and checks
+ * the configured algorithm against the generic CRC calculation.
+ */
+#include "common.h"
+#include "OneWireNg_CrcTab.h"
+
+#define BUF_SZ 0x400
+
+class OneWireNg_Crc_Test: OneWireNg
+{
+public:
+    static void fillBuf(uint8_t *buf, size_t len)
+    {
+        unsigned long r = 0x1234;
+        for (size_t i=0; i < len; i++) {
+            r = (r * 1103515245UL + 12345UL) & 0xffffffffUL;
+            buf[i] = (uint8_t)(r >> 16);
+        }
+    }
+
+    static void test_crc8()
+    {
+        uint8_t buf[BUF_SZ];
+        fillBuf(buf, sizeof(buf));
+
+        /* various lengths and alignments */
+        for (size_t off=0; off < 8; off++) {
+            for (size_t len=0; len <= 160; len++) {
+                assert(crc8(&buf[off], len) ==
+                    (crc<uint8_t, 0x8c>(&buf[off], len)));
+                assert(crc8(&buf[off], len, 0x5a) ==
+                    (crc<uint8_t, 0x8c>(&buf[off], len, 0x5a)));
+            }
+        }
+
+        /* chained calculation */
+        uint8_t c = 0;
+        for (size_t i=0; i < sizeof(buf); i+=0x55)
+            c = crc8(&buf[i], (sizeof(buf)-i < 0x55 ? sizeof(buf)-i : 0x55), c);
+        assert(c == crc8(buf, sizeof(buf)));
+
+        /* CRC-8/MAXIM check value; residue */
+        assert(crc8("123456789", 9) == 0xa1);
+        buf[0x40] = crc8(buf, 0x40);
+        assert(crc8(buf, 0x41) == 0);
+
+        TEST_SUCCESS();
+    }
+
+#ifdef CONFIG_CRC16_ENABLED
+    static void test_crc16()
+    {
+        uint8_t buf[BUF_SZ];
+        fillBuf(buf, sizeof(buf));
+
+        for (size_t off=0; off < 8; off++) {
+            for (size_t len=0; len <= 160; len++) {
+                assert(crc16(&buf[off], len) ==
+                    (crc<uint16_t, 0xa001>(&buf[off], len)));
+                assert(crc16(&buf[off], len, 0xa55a) ==
+                    (crc<uint16_t, 0xa001>(&buf[off], len, 0xa55a)));
+            }
+        }
+
+        uint16_t c = 0;
+        for (size_t i=0; i < sizeof(buf); i+=0x55)
+            c = crc16(&buf[i], (sizeof(buf)-i < 0x55 ? sizeof(buf)-i : 0x55), c);
+        assert(c == crc16(buf, sizeof(buf)));
+
+        /* CRC-16/ARC check value */
+        assert(crc16("123456789", 9) == 0xbb3d);
+
+        TEST_SUCCESS();
+    }
+#endif
+
+    static void test_crcCtx()
+    {
+        uint8_t buf[BUF_SZ];
+        fillBuf(buf, sizeof(buf));
+
+        /* byte-wise and chunked updates */
+        Crc8Ctx c8;
+        for (size_t i=0; i < 0x100; i++)
+            c8.update(buf[i]);
+        c8.update(&buf[0x100], 0x33);
+        assert(c8.final() == crc8(buf, 0x133));
+        assert(c8.check(crc8(buf, 0x133)) == EC_SUCCESS);
+        assert(c8.check(crc8(buf, 0x133) ^ 1) == EC_CRC_ERROR);
+
+        c8.reset(0x5a);
+        c8.update(buf, 0x10);
+        assert(c8.final() == crc8(buf, 0x10, 0x5a));
+
+#ifdef CONFIG_CRC16_ENABLED
+        Crc16Ctx c16;
+        for (size_t i=0; i < 0x100; i++)
+            c16.update(buf[i]);
+        c16.update(&buf[0x100], 0x33);
+
+        uint16_t c = crc16(buf, 0x133);
+        assert(c16.final() == c);
+        assert(c16.check(c) == EC_SUCCESS);
+        assert(c16.checkInv((uint16_t)~c) == EC_SUCCESS);
+        assert(c16.checkInv(c) == EC_CRC_ERROR);
+#endif
+        TEST_SUCCESS();
+    }
+
+    static void test_crcTab()
+    {
+        uint8_t buf[BUF_SZ];
+        fillBuf(buf, sizeof(buf));
+
+        /* compile time generated tables vs generic calculation */
+        for (size_t len=0; len <= 67; len++) {
+            assert((crcTab256<uint8_t, 0x8c>(buf, len, 0x5a)) ==
+                (crc<uint8_t, 0x8c>(buf, len, 0x5a)));
+            assert((crcTab256<uint16_t, 0xa001>(buf, len, 0xa55a)) ==
+                (crc<uint16_t, 0xa001>(buf, len, 0xa55a)));
+        }
+
+        for (unsigned i=0; i < 256; i++) {
+            uint8_t b = (uint8_t)i;
+            assert((crcTabRead<uint8_t>(&CrcTab256<uint8_t, 0x8c>::tab[i])) ==
+                (crc<uint8_t, 0x8c>(&b, 1)));
+        }
+
+        /* other CRC variants: CRC-16/MAXIM, CRC-32 check values */
+        uint16_t c16 = crcTab256<uint16_t, 0xa001>("123456789", 9);
+        assert((uint16_t)~c16 == 0x44c2);
+
+        uint32_t c32 = crcTab256<uint32_t, 0xedb88320UL>(
+            "123456789", 9, 0xffffffffUL);
+        assert(~c32 == 0xcbf43926UL);
+
+        TEST_SUCCESS();
+    }
+};
+
+int main(void)
+{
+    OneWireNg_Crc_Test::test_crc8();
+#ifdef CONFIG_CRC16_ENABLED
+    OneWireNg_Crc_Test::test_crc16();
+#endif
+    OneWireNg_Crc_Test::test_crcCtx();
+    OneWireNg_Crc_Test::test_crcTab();
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include "common.h"
+#include "OneWireNg_Simulated.h"
+#include "drivers/DSThermCache.h"
+
+class DSThermCache_Test
+{
+public:
+    static void test_config()
+    {
+        OneWireNg_Simulated ow;
+        DSTherm dsth(ow);
+        OneWireNg::Id id1, id2;
+
+        OneWireNg_Simulated::Slave::makeId(id1, DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::Slave::makeId(id2, DSTherm::DS18S20, 2);
+        OneWireNg_Simulated::DSThermSlave s1(id1), s2(id2);
+        ow.attach(s1);
+        ow.attach(s2);
+
+        DSThermCache::Entry entries[2];
+        DSThermCache cache(dsth, entries, TAB_SZ(entries));
+        const OneWireNg_Simulated::Stats& st = ow.getStats();
+
+        int8_t th, tl;
+        DSTherm::Resolution res;
+
+        /* the 1st access reads the sensor */
+        ow.resetStats();
+        assert(cache.getConfig(id1, &th, &tl, &res) == OneWireNg::EC_SUCCESS);
+        assert(res == DSTherm::RES_12_BIT && st.std.reset == 1);
+
+        /* cached; no bus activity */
+        ow.resetStats();
+        assert(cache.getConfig(id1, &th, &tl, &res) == OneWireNg::EC_SUCCESS);
+        assert(st.std.reset == 0);
+
+        /* written only if changed */
+        assert(cache.setConfig(id1, 30, -30, DSTherm::RES_10_BIT) ==
+            OneWireNg::EC_SUCCESS);
+        assert(s1.getScratchpad()[2] == 30 &&
+            (int8_t)s1.getScratchpad()[3] == -30 && cache.isDirty(id1));
+
+        ow.resetStats();
+        assert(cache.setConfig(id1, 30, -30, DSTherm::RES_10_BIT) ==
+            OneWireNg::EC_SUCCESS);
+        assert(st.std.reset == 0);
+
+        assert(cache.getConfig(id1, &th, &tl, &res) == OneWireNg::EC_SUCCESS);
+        assert(th == 30 && tl == -30 && res == DSTherm::RES_10_BIT);
+
+        /* DS18S20: resolution is not configurable */
+        assert(cache.getConfig(id2, &th, &tl, &res) == OneWireNg::EC_SUCCESS);
+        assert(res == DSTherm::RES_9_BIT);
+
+        ow.resetStats();
+        assert(cache.setConfig(id2, th, tl, DSTherm::RES_12_BIT) ==
+            OneWireNg::EC_SUCCESS);
+        assert(st.std.reset == 0 && !cache.isDirty(id2));
+
+        /* write-back */
+        assert(s1.getEeprom()[0] != 30);
+        ow.resetStats();
+        assert(cache.writeBackAll() == OneWireNg::EC_SUCCESS);
+        assert(st.std.reset == 1 && !cache.isDirty(id1));
+        assert(s1.getEeprom()[0] == 30 && (int8_t)s1.getEeprom()[1] == -30);
+
+        ow.resetStats();
+        assert(cache.writeBack(id1) == OneWireNg::EC_SUCCESS &&
+            cache.writeBackAll() == OneWireNg::EC_SUCCESS);
+        assert(st.std.reset == 0);
+
+        /* cache full; sensor accessed directly */
+        DSThermCache cache1(dsth, entries, 1);
+        assert(cache1.getConfig(id1, &th, &tl) == OneWireNg::EC_SUCCESS);
+        assert(cache1.setConfig(id2, 10, -10) == OneWireNg::EC_SUCCESS);
+        assert(s2.getScratchpad()[2] == 10 && cache1.isDirty(id2) &&
+            !cache1.isDirty(id1));
+
+        ow.resetStats();
+        assert(cache1.getConfig(id2, &th, &tl) == OneWireNg::EC_SUCCESS);
+        assert(th == 10 && tl == -10 && st.std.reset == 1);
+
+        /* pending change of not cached sensor is written back */
+        assert(s2.getEeprom()[0] != 10);
+        assert(cache1.writeBack(id2) == OneWireNg::EC_SUCCESS);
+        assert(s2.getEeprom()[0] == 10 && cache1.isDirty(id2));
+        assert(cache1.writeBackAll() == OneWireNg::EC_SUCCESS);
+        assert(!cache1.isDirty(id2));
+
+        ow.resetStats();
+        assert(cache1.writeBackAll() == OneWireNg::EC_SUCCESS);
+        assert(st.std.reset == 0);
+
+        /* invalidated entry is re-read; its change stays pending */
+        assert(cache1.setConfig(id1, 31, -30, DSTherm::RES_10_BIT) ==
+            OneWireNg::EC_SUCCESS && cache1.isDirty(id1));
+        cache1.invalidate(id1);
+        assert(cache1.isDirty(id1));
+        ow.resetStats();
+        assert(cache1.getConfig(id1, &th, &tl) == OneWireNg::EC_SUCCESS);
+        assert(th == 31 && st.std.reset == 1);
+
+        assert(s1.getEeprom()[0] != 31);
+        assert(cache1.writeBackAll() == OneWireNg::EC_SUCCESS);
+        assert(s1.getEeprom()[0] == 31 && !cache1.isDirty(id1));
+
+        /* not connected sensor */
+        OneWireNg::Id id3;
+        OneWireNg_Simulated::Slave::makeId(id3, DSTherm::DS18B20, 3);
+        assert(cache.getConfig(id3, &th, &tl) != OneWireNg::EC_SUCCESS);
+
+        TEST_SUCCESS();
+    }
+};
+
+int main(void)
+{
+    DSThermCache_Test::test_config();
+
+    return 0;
+}
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include "common.h"
+#include "OneWireNg_SimulatedDS2482.h"
+#include "drivers/DSTherm.h"
+
+typedef OneWireNg_Simulated::Slave Slave;
+
+class OneWireNg_DS2482_Test
+{
+public:
+    static void test_reset()
+    {
+        OneWireNg_Simulated bus;
+        OneWireNg_Simulated *buses[] = {&bus};
+        OneWireNg_SimulatedDS2482 i2c(buses);
+        OneWireNg_DS2482 ow(i2c);
+
+        assert(ow.begin() == OneWireNg::EC_SUCCESS);
+        assert(i2c.getConfig() == OneWireNg_DS2482::CONFIG_APU);
+
+        /* no slaves */
+        assert(ow.reset() == OneWireNg::EC_NO_DEVS);
+        assert(bus.getStats().std.reset == 1);
+
+        OneWireNg::Id id;
+        Slave::makeId(id, DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::DSThermSlave s(id);
+        bus.attach(s);
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+
+        /* the DS2482 busy state is polled */
+        i2c.setBusyReads(5);
+        i2c.resetStats();
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        assert(i2c.getStats().writes == 1 && i2c.getStats().reads == 6);
+
+        i2c.setBusyReads(OneWireNg_DS2482::BUSY_POLLS);
+        assert(ow.reset() == OneWireNg::EC_BUS_ERROR);
+
+        /* DS2482 not responding at the address */
+        OneWireNg_DS2482 ow1(i2c, OneWireNg_DS2482::I2C_ADDR + 1);
+        assert(ow1.begin() == OneWireNg::EC_BUS_ERROR);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_touch()
+    {
+        OneWireNg_Simulated bus;
+        OneWireNg_Simulated *buses[] = {&bus};
+        OneWireNg_SimulatedDS2482 i2c(buses);
+        OneWireNg_DS2482 ow(i2c);
+        const OneWireNg_SimulatedDS2482::Stats& st = i2c.getStats();
+
+        OneWireNg::Id id, rid;
+        Slave::makeId(id, DSTherm::DS18B20, 0x123456);
+        OneWireNg_Simulated::DSThermSlave s(id);
+        bus.attach(s);
+        assert(ow.begin() == OneWireNg::EC_SUCCESS);
+
+        /* bytes are touched by the byte commands */
+        i2c.resetStats();
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        ow.writeByte(OneWireNg::CMD_READ_ROM);
+        ow.readBytes(rid, sizeof(rid));
+        assert(!memcmp(id, rid, sizeof(id)));
+        assert(st.wrByte == 1 && st.rdByte == sizeof(id) && st.bit == 0);
+
+        /* single bit touch */
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        ow.writeByte(OneWireNg::CMD_READ_ROM);
+        for (int i = 0; i < 8; i++)
+            assert(ow.touchBit(1) == ((id[0] >> i) & 1));
+
+        /* mixed read/write bytes */
+        uint8_t cmd[1 + sizeof(OneWireNg::Id)];
+        cmd[0] = OneWireNg::CMD_READ_ROM;
+        memset(&cmd[1], 0xff, sizeof(OneWireNg::Id));
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        ow.touchBytes(cmd, sizeof(cmd));
+        assert(cmd[0] == OneWireNg::CMD_READ_ROM &&
+            !memcmp(&cmd[1], id, sizeof(id)));
+
+        /* mixed bits byte touched bit by bit, sampled bits returned */
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        ow.writeByte(OneWireNg::CMD_READ_ROM);
+        i2c.resetStats();
+        assert(ow.touchByte(0x0f) == (id[0] & 0x0f));
+        assert(ow.touchByte(0xf0) == (id[1] & 0xf0));
+        assert(st.bit == 16 && st.wrByte == 0 && st.rdByte == 0);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_search()
+    {
+        OneWireNg_Simulated bus;
+        OneWireNg_Simulated *buses[] = {&bus};
+        OneWireNg_SimulatedDS2482 i2c(buses);
+        OneWireNg_DS2482 ow(i2c);
+        const OneWireNg_SimulatedDS2482::Stats& st = i2c.getStats();
+
+        OneWireNg::Id ids[8];
+        OneWireNg_Simulated::DSThermSlave *slaves[TAB_SZ(ids)];
+
+        for (size_t i = 0; i < TAB_SZ(ids); i++) {
+            Slave::makeId(ids[i], DSTherm::DS18B20, 0x1000 + 0x35 * i);
+            slaves[i] = new OneWireNg_Simulated::DSThermSlave(ids[i]);
+        }
+        assert(ow.begin() == OneWireNg::EC_SUCCESS);
+
+        /* single slave: 64 triplets */
+        bus.attach(*slaves[0]);
+
+        OneWireNg::Id id;
+        i2c.resetStats();
+        ow.searchReset();
+        assert(ow.search(id) == OneWireNg::EC_DONE);
+        assert(!memcmp(id, ids[0], sizeof(id)));
+        assert(st.reset == 1 && st.wrByte == 1 &&
+            st.triplet == 8*sizeof(OneWireNg::Id) && st.bit == 0);
+        assert(bus.getStats().std.write0 + bus.getStats().std.write1 ==
+            8 + 3*8*sizeof(OneWireNg::Id));
+
+        /* all slaves */
+        for (size_t i = 1; i < TAB_SZ(ids); i++)
+            bus.attach(*slaves[i]);
+
+        OneWireNg::Id found[TAB_SZ(ids)];
+        size_t n;
+        assert(ow.searchAll(found, TAB_SZ(found), &n) == OneWireNg::EC_SUCCESS);
+        assert(n == TAB_SZ(ids));
+
+        for (size_t i = 0; i < TAB_SZ(ids); i++) {
+            bool match = false;
+            for (size_t j = 0; j < n && !match; j++)
+                match = !memcmp(ids[i], found[j], sizeof(OneWireNg::Id));
+            assert(match);
+        }
+
+        /* family code filtering */
+        Slave::makeId(id, DSTherm::DS18S20, 0x2000);
+        OneWireNg_Simulated::DSThermSlave s1(id);
+        bus.attach(s1);
+
+        ow.searchFilterAdd(DSTherm::DS18S20);
+        ow.searchReset();
+        assert(ow.search(found[0]) == OneWireNg::EC_DONE);
+        assert(!memcmp(found[0], id, sizeof(id)));
+
+        bus.detachAll();
+        for (size_t i = 0; i < TAB_SZ(ids); i++)
+            delete slaves[i];
+
+        TEST_SUCCESS();
+    }
+
+    static void test_dstherm()
+    {
+        OneWireNg_Simulated bus;
+        OneWireNg_Simulated *buses[] = {&bus};
+        OneWireNg_SimulatedDS2482 i2c(buses);
+        OneWireNg_DS2482 ow(i2c);
+        DSTherm dsth(ow);
+
+        OneWireNg::Id id1, id2;
+        Slave::makeId(id1, DSTherm::DS18B20, 1);
+        Slave::makeId(id2, DSTherm::DS18B20, 2);
+        OneWireNg_Simulated::DSThermSlave s1(id1), s2(id2, true);
+        s1.setTemp(21500);
+        s2.setTemp(-10250);
+        bus.attach(s1);
+        bus.attach(s2);
+        assert(ow.begin() == OneWireNg::EC_SUCCESS);
+
+        /*
+         * parasitic powering via the strong pull-up armed before the command
+         * byte (no additional 1-wire slot issued)
+         */
+        i2c.resetStats();
+        assert(dsth.convertTempAll(DSTherm::MAX_CONV_TIME, true) ==
+            OneWireNg::EC_SUCCESS);
+        assert(bus.getTime() >= 1000L * DSTherm::MAX_CONV_TIME);
+        assert(i2c.getStats().bit == 0 && i2c.getStats().wrByte == 2);
+        assert(!bus.isPowered() &&
+            (i2c.getConfig() & OneWireNg_DS2482::CONFIG_SPU) == 0);
+
+        long temp;
+        assert(dsth.readTemp(id1, &temp) == OneWireNg::EC_SUCCESS);
+        assert(temp == 21500);
+        assert(dsth.readTemp(id2, &temp) == OneWireNg::EC_SUCCESS);
+        assert(temp == -10250);
+
+        /* strong pull-up disabled on demand */
+        assert(ow.powerBus(true) == OneWireNg::EC_SUCCESS && bus.isPowered());
+        assert(ow.powerBus(false) == OneWireNg::EC_SUCCESS && !bus.isPowered());
+
+        /* strong pull-up re-armed for consecutive writes */
+        assert(ow.writeBytePwr(0xcc) == OneWireNg::EC_SUCCESS &&
+            bus.isPowered());
+        assert(ow.writeBytePwr(0x44) == OneWireNg::EC_SUCCESS &&
+            bus.isPowered());
+        assert(ow.powerBus(false) == OneWireNg::EC_SUCCESS && !bus.isPowered());
+
+        TEST_SUCCESS();
+    }
+
+    static void test_channels()
+    {
+        OneWireNg_Simulated bus[OneWireNg_DS2482::CHANNELS_800];
+        OneWireNg_Simulated *buses[OneWireNg_DS2482::CHANNELS_800];
+
+        for (int i = 0; i < OneWireNg_DS2482::CHANNELS_800; i++)
+            buses[i] = &bus[i];
+
+        OneWireNg_SimulatedDS2482 i2c(buses, OneWireNg_DS2482::CHANNELS_800);
+        OneWireNg_DS2482 ow(i2c);
+
+        OneWireNg::Id id1, id2, id;
+        Slave::makeId(id1, DSTherm::DS18B20, 1);
+        Slave::makeId(id2, DSTherm::DS18B20, 2);
+        OneWireNg_Simulated::DSThermSlave s1(id1), s2(id2);
+        bus[2].attach(s1);
+        bus[7].attach(s2);
+
+        assert(ow.begin() == OneWireNg::EC_SUCCESS && i2c.getChannel() == 0);
+        assert(ow.reset() == OneWireNg::EC_NO_DEVS);
+
+        assert(ow.selectChannel(2) == OneWireNg::EC_SUCCESS);
+        assert(i2c.getChannel() == 2);
+        ow.searchReset();
+        assert(ow.search(id) == OneWireNg::EC_DONE &&
+            !memcmp(id, id1, sizeof(id)));
+
+        assert(ow.selectChannel(7) == OneWireNg::EC_SUCCESS);
+        ow.searchReset();
+        assert(ow.search(id) == OneWireNg::EC_DONE &&
+            !memcmp(id, id2, sizeof(id)));
+        assert(bus[2].getStats().std.reset == 1);
+
+        assert(ow.selectChannel(OneWireNg_DS2482::CHANNELS_800) ==
+            OneWireNg::EC_UNSUPPORED);
+        assert(i2c.getChannel() == 7);
+
+        /* DS2482-100 has no channels */
+        OneWireNg_SimulatedDS2482 i2c1(buses);
+        OneWireNg_DS2482 ow1(i2c1);
+        assert(ow1.begin() == OneWireNg::EC_SUCCESS);
+        assert(ow1.selectChannel(1) == OneWireNg::EC_UNSUPPORED);
+
+        TEST_SUCCESS();
+    }
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+    static void test_overdrive()
+    {
+        OneWireNg_Simulated bus;
+        OneWireNg_Simulated *buses[] = {&bus};
+        OneWireNg_SimulatedDS2482 i2c(buses);
+        OneWireNg_DS2482 ow(i2c);
+
+        OneWireNg::Id id1, id2, id;
+        Slave::makeId(id1, 0x2d, 1);    /* DS2431 */
+        Slave::makeId(id2, DSTherm::DS18B20, 2);
+        OneWireNg_Simulated::DS2431Slave s1(id1);
+        OneWireNg_Simulated::DSThermSlave s2(id2);
+        bus.attach(s1);
+        bus.attach(s2);
+        assert(ow.begin() == OneWireNg::EC_SUCCESS);
+
+        /* speed switched by the DS2482 configuration */
+        assert(ow.overdriveAll() == OneWireNg::EC_SUCCESS);
+        bus.resetStats();
+        ow.searchReset();
+        assert(ow.search(id) == OneWireNg::EC_DONE &&
+            !memcmp(id, id1, sizeof(id)));
+        assert(i2c.getConfig() & OneWireNg_DS2482::CONFIG_1WS);
+        assert(bus.getStats().od.reset == 1 && bus.getStats().std.reset == 0);
+
+        ow.setOverdrive(false);
+        ow.searchReset();
+        assert(ow.search(id) == OneWireNg::EC_MORE);
+        assert(!(i2c.getConfig() & OneWireNg_DS2482::CONFIG_1WS));
+
+        TEST_SUCCESS();
+    }
+#endif
+};
+
+int main(void)
+{
+    OneWireNg_DS2482_Test::test_reset();
+    OneWireNg_DS2482_Test::test_touch();
+    OneWireNg_DS2482_Test::test_search();
+    OneWireNg_DS2482_Test::test_dstherm();
+    OneWireNg_DS2482_Test::test_channels();
+#ifdef CONFIG_OVERDRIVE_ENABLED
+    OneWireNg_DS2482_Test::test_overdrive();
+#endif
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include "common.h"
+#include "OneWireNg_SimulatedUart.h"
+#include "drivers/DSTherm.h"
+
+typedef OneWireNg_Simulated::Slave Slave;
+
+class OneWireNg_Uart_Test
+{
+public:
+    static void test_reset()
+    {
+        OneWireNg_Simulated bus;
+        OneWireNg_SimulatedUart uart(bus);
+        OneWireNg_Uart ow(uart);
+
+        /* no slaves */
+        assert(ow.reset() == OneWireNg::EC_NO_DEVS);
+        assert(uart.getBaud() == OneWireNg_Uart::RESET_BAUD);
+        assert(bus.getStats().std.reset == 1);
+
+        OneWireNg::Id id;
+        Slave::makeId(id, DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::DSThermSlave s(id);
+        bus.attach(s);
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+
+        /* baud rate is switched only if needed */
+        uart.resetStats();
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        assert(uart.getStats().bauds == 0);
+        ow.writeByte(OneWireNg::CMD_SKIP_ROM);
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        assert(uart.getStats().bauds == 2);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_touch()
+    {
+        OneWireNg_Simulated bus;
+        OneWireNg_SimulatedUart uart(bus);
+        OneWireNg_Uart ow(uart);
+        const OneWireNg_SimulatedUart::Stats& st = uart.getStats();
+
+        OneWireNg::Id id, rid;
+        Slave::makeId(id, DSTherm::DS18B20, 0x123456);
+        OneWireNg_Simulated::DSThermSlave s(id);
+        bus.attach(s);
+
+        /* bytes are transmitted in bursts of 8 characters per byte */
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        uart.resetStats();
+        ow.writeByte(OneWireNg::CMD_READ_ROM);
+        ow.readBytes(rid, sizeof(rid));
+        assert(!memcmp(id, rid, sizeof(id)));
+        assert(st.bursts == 2 && st.chars == 8*(1 + sizeof(id)));
+
+        /* long transfers are split into bursts */
+        uint8_t cmd[1 + 2*CONFIG_UART_BURST_BYTES];
+        cmd[0] = OneWireNg::CMD_READ_ROM;
+        memset(&cmd[1], 0xff, sizeof(cmd) - 1);
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        uart.resetStats();
+        ow.touchBytes(cmd, sizeof(cmd));
+        assert(cmd[0] == OneWireNg::CMD_READ_ROM &&
+            !memcmp(&cmd[1], id, sizeof(id)));
+        assert(st.bursts == 3 && st.chars == 8*sizeof(cmd));
+
+        /* single bit touch */
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        ow.writeByte(OneWireNg::CMD_READ_ROM);
+        for (int i = 0; i < 8; i++)
+            assert(ow.touchBit(1) == ((id[0] >> i) & 1));
+
+        /* released bus is read if the baud rate can't be set */
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        uart.setBaudFault(true);
+        memset(rid, 0, sizeof(rid));
+        ow.readBytes(rid, sizeof(rid));
+        for (size_t i = 0; i < sizeof(rid); i++)
+            assert(rid[i] == 0xff);
+        uart.setBaudFault(false);
+
+        TEST_SUCCESS();
+    }
+
+    static void test_search()
+    {
+        OneWireNg_Simulated bus;
+        OneWireNg_SimulatedUart uart(bus);
+        OneWireNg_Uart ow(uart);
+        const OneWireNg_SimulatedUart::Stats& st = uart.getStats();
+
+        OneWireNg::Id ids[8];
+        OneWireNg_Simulated::DSThermSlave *slaves[TAB_SZ(ids)];
+
+        for (size_t i = 0; i < TAB_SZ(ids); i++) {
+            Slave::makeId(ids[i], DSTherm::DS18B20, 0x1000 + 0x35 * i);
+            slaves[i] = new OneWireNg_Simulated::DSThermSlave(ids[i]);
+        }
+
+        /* single slave: 2 bursts per triplet */
+        bus.attach(*slaves[0]);
+
+        OneWireNg::Id id;
+        ow.searchReset();
+        assert(ow.search(id) == OneWireNg::EC_DONE);
+        assert(!memcmp(id, ids[0], sizeof(id)));
+        assert(st.bursts == 2 + 2*8*sizeof(OneWireNg::Id));
+        assert(bus.getStats().std.write0 + bus.getStats().std.write1 ==
+            8 + 3*8*sizeof(OneWireNg::Id));
+
+        /* failed direction write; the search path is unknown */
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        ow.writeByte(OneWireNg::CMD_SEARCH_ROM);
+        uart.setXferFault(2);
+        assert(ow.touchTriplet(0) == 3);
+
+        /* all slaves */
+        for (size_t i = 1; i < TAB_SZ(ids); i++)
+            bus.attach(*slaves[i]);
+
+        OneWireNg::Id found[TAB_SZ(ids)];
+        size_t n;
+        assert(ow.searchAll(found, TAB_SZ(found), &n) == OneWireNg::EC_SUCCESS);
+        assert(n == TAB_SZ(ids));
+
+        for (size_t i = 0; i < TAB_SZ(ids); i++) {
+            bool match = false;
+            for (size_t j = 0; j < n && !match; j++)
+                match = !memcmp(ids[i], found[j], sizeof(OneWireNg::Id));
+            assert(match);
+        }
+
+        bus.detachAll();
+        for (size_t i = 0; i < TAB_SZ(ids); i++)
+            delete slaves[i];
+
+        TEST_SUCCESS();
+    }
+
+    static void test_dstherm()
+    {
+        OneWireNg_Simulated bus;
+        OneWireNg_SimulatedUart uart(bus);
+        OneWireNg_Uart ow(uart);
+        DSTherm dsth(ow);
+
+        OneWireNg::Id id1, id2;
+        Slave::makeId(id1, DSTherm::DS18B20, 1);
+        Slave::makeId(id2, DSTherm::DS18S20, 2);
+        OneWireNg_Simulated::DSThermSlave s1(id1), s2(id2);
+        s1.setTemp(21500);
+        s2.setTemp(-10500);
+        bus.attach(s1);
+        bus.attach(s2);
+
+        assert(dsth.convertTempAll() == OneWireNg::EC_SUCCESS);
+
+        long temp;
+        assert(dsth.readTemp(id1, &temp) == OneWireNg::EC_SUCCESS);
+        assert(temp == 21500);
+        assert(dsth.readTemp(id2, &temp) == OneWireNg::EC_SUCCESS);
+        assert(temp == -10500);
+
+        /*
+         * full scratchpad read in bulk: reset, match rom, id, read command
+         * and 9 bytes (2 bursts)
+         */
+        uint8_t scrpd[DSTherm::Scratchpad::LENGTH];
+        uart.resetStats();
+        assert(dsth.readScratchpad(id1, scrpd) == OneWireNg::EC_SUCCESS);
+        assert(uart.getStats().bursts == 4 + 2);
+
+        /* bus powering is not supported */
+        assert(ow.powerBus(true) == OneWireNg::EC_UNSUPPORED);
+
+        TEST_SUCCESS();
+    }
+};
+
+int main(void)
+{
+    OneWireNg_Uart_Test::test_reset();
+    OneWireNg_Uart_Test::test_touch();
+    OneWireNg_Uart_Test::test_search();
+    OneWireNg_Uart_Test::test_dstherm();
+
+    return 0;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/*
+ * ESP32 RMT platform run against the host model of the RMT peripheral
+ * (esp32/esp32_sim.h) connected to a simulated 1-wire bus.
+ */
+#include "common.h"
+#include "platform/OneWireNg_ArduinoESP32_Rmt.h"
+#include "drivers/DSTherm.h"
+
+typedef OneWireNg_Simulated::Slave Slave;
+
+class OneWireNg_ArduinoESP32_Rmt_Test
+{
+public:
+    /* access to the protected RMT transfer routines */
+    class Rmt: public OneWireNg_ArduinoESP32_Rmt
+    {
+    public:
+        Rmt(): OneWireNg_ArduinoESP32_Rmt(4, true) {}
+
+        using OneWireNg_ArduinoESP32_Rmt::xfer;
+        using OneWireNg_ArduinoESP32_Rmt::touchBitsEng;
+        using OneWireNg_ArduinoESP32_Rmt::setItem;
+        using OneWireNg_ArduinoESP32_Rmt::RX_IDLE_US;
+        using OneWireNg_ArduinoESP32_Rmt::RX_IDLE_RESET_US;
+    };
+
+    static void test_reset()
+    {
+        OneWireNg_Simulated bus;
+        esp32_sim_attach(&bus);
+        Rmt ow;
+
+        /* no slaves */
+        assert(ow.reset() == OneWireNg::EC_NO_DEVS);
+        assert(bus.getStats().std.reset == 1);
+
+        OneWireNg::Id id;
+        Slave::makeId(id, DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::DSThermSlave s(id);
+        bus.attach(s);
+
+        /* presence pulse recorded after the reset pulse in the same frame */
+        unsigned long t = bus.getTime();
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        assert(esp32_sim_get().frames == 2 && esp32_sim_get().idleCuts == 0);
+        assert(bus.getTime() - t == STD_RESET_TIME + Rmt::RX_IDLE_RESET_US);
+
+        uint16_t lowTicks[2];
+        unsigned lows;
+        rmt_item32_t item;
+        Rmt::setItem(item, STD_RESET_LOW, STD_RESET_SMPL + STD_RESET_END);
+        assert(ow.xfer(&item, 1, lowTicks, &lows, Rmt::RX_IDLE_RESET_US) ==
+            ESP_OK);
+        assert(lows == 2 && lowTicks[0] == STD_RESET_LOW * 10);
+
+        /* slots bursts idle threshold cuts the frame after the reset pulse */
+        assert(ow.xfer(&item, 1, lowTicks, &lows) == ESP_OK);
+        assert(lows == 1 && esp32_sim_get().idleCuts == 1);
+
+        /* the threshold is restored for the reset */
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+
+        bus.detachAll();
+        TEST_SUCCESS();
+    }
+
+    static void test_touch()
+    {
+        OneWireNg_Simulated bus;
+        esp32_sim_attach(&bus);
+        Rmt ow;
+
+        OneWireNg::Id id, rid;
+        Slave::makeId(id, DSTherm::DS18B20, 0x123456);
+        OneWireNg_Simulated::DSThermSlave s(id);
+        bus.attach(s);
+
+        /* read slots decoded from the recorded low pulses widths */
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        ow.writeByte(OneWireNg::CMD_READ_ROM);
+
+        uint8_t in[8] = {1, 1, 1, 1, 1, 1, 1, 1}, out[8];
+        ow.touchBitsEng(in, out, 8);
+        for (int i = 0; i < 8; i++)
+            assert(out[i] == ((id[0] >> i) & 1));
+
+        /* long transfers are split into bursts */
+        uint8_t cmd[1 + 2*CONFIG_ESP32_RMT_BURST_BYTES];
+        cmd[0] = OneWireNg::CMD_READ_ROM;
+        memset(&cmd[1], 0xff, sizeof(cmd) - 1);
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        unsigned long frames = esp32_sim_get().frames;
+        ow.touchBytes(cmd, sizeof(cmd));
+        assert(cmd[0] == OneWireNg::CMD_READ_ROM &&
+            !memcmp(&cmd[1], id, sizeof(id)));
+        assert(esp32_sim_get().frames - frames == 3);
+
+        /* mixed bits byte */
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        ow.writeByte(OneWireNg::CMD_READ_ROM);
+        assert(ow.touchByte(0x0f) == (id[0] & 0x0f));
+        ow.readBytes(rid, sizeof(rid) - 1);
+        assert(!memcmp(&id[1], rid, sizeof(rid) - 1));
+
+        /* single bit touch */
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        ow.writeByte(OneWireNg::CMD_READ_ROM);
+        for (int i = 0; i < 8; i++)
+            assert(ow.touchBit(1) == ((id[0] >> i) & 1));
+
+        /* a burst is completed after the slots idle threshold */
+        unsigned long t = bus.getTime();
+        assert(ow.readByte() == id[1]);
+        assert(bus.getTime() - t == 8*STD_WRITE1_TIME + Rmt::RX_IDLE_US);
+
+        t = bus.getTime();
+        assert(ow.touchBit(1) == (id[2] & 1));
+        assert(bus.getTime() - t == STD_WRITE1_TIME + Rmt::RX_IDLE_US);
+
+        assert(esp32_sim_get().idleCuts == 0);
+
+        bus.detachAll();
+        TEST_SUCCESS();
+    }
+
+    static void test_search()
+    {
+        OneWireNg_Simulated bus;
+        esp32_sim_attach(&bus);
+        Rmt ow;
+
+        OneWireNg::Id ids[8];
+        OneWireNg_Simulated::DSThermSlave *slaves[TAB_SZ(ids)];
+
+        for (size_t i = 0; i < TAB_SZ(ids); i++) {
+            Slave::makeId(ids[i], DSTherm::DS18B20, 0x1000 + 0x35 * i);
+            slaves[i] = new OneWireNg_Simulated::DSThermSlave(ids[i]);
+            bus.attach(*slaves[i]);
+        }
+
+        /* triplet: read slots burst followed by the direction write */
+        assert(ow.reset() == OneWireNg::EC_SUCCESS);
+        ow.writeByte(OneWireNg::CMD_SEARCH_ROM);
+        unsigned long frames = esp32_sim_get().frames;
+        unsigned long t = bus.getTime();
+        /* family code LSB is 0 for all the slaves */
+        assert(ow.touchTriplet(1) == 2);
+        assert(esp32_sim_get().frames - frames == 2);
+        assert(bus.getTime() - t ==
+            2*(STD_WRITE1_TIME + Rmt::RX_IDLE_US) + STD_WRITE0_TIME);
+
+        /* 2 bursts per id bit */
+        OneWireNg::Id found[TAB_SZ(ids)];
+        size_t n;
+        frames = esp32_sim_get().frames;
+        assert(ow.searchAll(found, TAB_SZ(found), &n) == OneWireNg::EC_SUCCESS);
+        assert(n == TAB_SZ(ids));
+        assert(esp32_sim_get().frames - frames ==
+            TAB_SZ(ids) * (1 + 1 + 2*8*sizeof(OneWireNg::Id)));
+
+        for (size_t i = 0; i < TAB_SZ(ids); i++) {
+            bool match = false;
+            for (size_t j = 0; j < n && !match; j++)
+                match = !memcmp(ids[i], found[j], sizeof(OneWireNg::Id));
+            assert(match);
+        }
+
+        bus.detachAll();
+        for (size_t i = 0; i < TAB_SZ(ids); i++)
+            delete slaves[i];
+
+        TEST_SUCCESS();
+    }
+
+    static void test_power()
+    {
+        OneWireNg_Simulated bus;
+        esp32_sim_attach(&bus);
+        Rmt ow;
+
+        OneWireNg::Id id;
+        Slave::makeId(id, DSTherm::DS18B20, 1);
+        OneWireNg_Simulated::DSThermSlave s(id);
+        bus.attach(s);
+
+        /* the bus is unpowered by the next 1-wire activity */
+        assert(ow.powerBus(true) == OneWireNg::EC_SUCCESS && bus.isPowered());
+        assert(ow.reset() == OneWireNg::EC_SUCCESS && !bus.isPowered());
+
+        assert(ow.writeBytePwr(OneWireNg::CMD_SKIP_ROM) ==
+            OneWireNg::EC_SUCCESS && bus.isPowered());
+        ow.readByte();
+        assert(!bus.isPowered());
+
+        bus.detachAll();
+        TEST_SUCCESS();
+    }
+};
+
+int main(void)
+{
+    OneWireNg_ArduinoESP32_Rmt_Test::test_reset();
+    OneWireNg_ArduinoESP32_Rmt_Test::test_touch();
+    OneWireNg_ArduinoESP32_Rmt_Test::test_search();
+    OneWireNg_ArduinoESP32_Rmt_Test::test_power();
+
+    return 0;
+}
@@ -1,10 +1,24 @@
 /* common configuration */
 #define CONFIG_CRC16_ENABLED
-#define CONFIG_CRC8_ALGO CRC8_TAB_16LH
-#define CONFIG_CRC16_ALGO CRC16_TAB_16LH
+
+/* CRC algorithms may be chosen by the test build */
+#ifndef CONFIG_CRC8_ALGO
+# define CONFIG_CRC8_ALGO CRC8_TAB_16LH
+#endif
+#ifndef CONFIG_CRC16_ALGO
+# define CONFIG_CRC16_ALGO CRC16_TAB_16LH
+#endif
 
 #if defined(T03)
 # define CONFIG_MAX_SRCH_FILTERS 5
 #else
 # define CONFIG_MAX_SRCH_FILTERS 10
 #endif
+
+#if defined(T02) || defined(T04) || defined(T07)
+# define CONFIG_OVERDRIVE_ENABLED
+#endif
+
+#if defined(T02) || defined(T07) || defined(T08) || defined(T09)
+# define CONFIG_EXT_VIRTUAL_INTF
+#endif
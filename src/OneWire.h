@@ -86,15 +86,21 @@ public:
     }
 
     void write(uint8_t v, uint8_t power = 0) {
-        _ow->writeByte(v);
         if (power)
-            _ow->powerBus(true);
+            _ow->writeBytePwr(v);
+        else
+            _ow->writeByte(v);
     }
 
     void write_bytes(const uint8_t *buf, uint16_t count, bool power = 0) {
-        _ow->writeBytes(buf, count);
-        if (power)
-            _ow->powerBus(true);
+        if (power && count > 0) {
+            _ow->writeBytes(buf, count - 1);
+            _ow->writeBytePwr(buf[count - 1]);
+        } else {
+            _ow->writeBytes(buf, count);
+            if (power)
+                _ow->powerBus(true);
+        }
     }
 
     uint8_t read(void) {
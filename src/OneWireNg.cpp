@@ -13,32 +13,32 @@
 #include <string.h>
 #include "OneWireNg.h"
 
-#define CRC8_BASIC      1
-#define CRC8_TAB_16LH   2
+#define CRC8_BASIC          1
+#define CRC8_TAB_16LH       2
+#define CRC8_TAB_256        3
+#define CRC8_SLICING_BY_4   4
 
-#define CRC16_BASIC     1
-#define CRC16_TAB_16LH  2
+#define CRC16_BASIC         1
+#define CRC16_TAB_16LH      2
+#define CRC16_TAB_256       3
+#define CRC16_SLICING_BY_8  4
 
 #if defined(CONFIG_CRC8_ALGO) && \
-    !(CONFIG_CRC8_ALGO == CRC8_BASIC || CONFIG_CRC8_ALGO == CRC8_TAB_16LH)
+    !(CONFIG_CRC8_ALGO == CRC8_BASIC || CONFIG_CRC8_ALGO == CRC8_TAB_16LH || \
+      CONFIG_CRC8_ALGO == CRC8_TAB_256 || CONFIG_CRC8_ALGO == CRC8_SLICING_BY_4)
 # error Invalid CONFIG_CRC8_ALGO
 #endif
 
 #if defined(CONFIG_CRC16_ALGO) && \
-    !(CONFIG_CRC16_ALGO == CRC16_BASIC || CONFIG_CRC16_ALGO == CRC16_TAB_16LH)
+    !(CONFIG_CRC16_ALGO == CRC16_BASIC || CONFIG_CRC16_ALGO == CRC16_TAB_16LH || \
+      CONFIG_CRC16_ALGO == CRC16_TAB_256 || CONFIG_CRC16_ALGO == CRC16_SLICING_BY_8)
 # error Invalid CONFIG_CRC16_ALGO
 #endif
 
-#ifdef CONFIG_FLASH_CRC_TAB
-# include "platform/Platform_FlashMem.h"
-# define tabRead_u8 flashRead_u8
-# define tabRead_u16 flashRead_u16
-# define tabRead_u32 flashRead_u32
-#else
-# define CRCTAB_STORAGE
-# define tabRead_u8(addr) (*(const uint8_t*)(addr))
-# define tabRead_u16(addr) (*(const uint16_t*)(addr))
-# define tabRead_u32(addr) (*(const uint32_t*)(addr))
+#include "OneWireNg_CrcTab.h"
+
+#ifdef CONFIG_PLATFORM_CRC
+# include "platform/Platform_Crc.h"
 #endif
 
 uint8_t OneWireNg::touchByte(uint8_t byte)
@@ -51,15 +51,48 @@ uint8_t OneWireNg::touchByte(uint8_t byte)
     return ret;
 }
 
+int OneWireNg::touchTriplet(int dir)
+{
+    int v0 = touchBit(1);   /* 0-presence */
+    int v1 = touchBit(1);   /* 1-presence */
+
+    if (v1 && v0)
+        return 3;
+
+    if (v1 || v0)
+        dir = !v1;
+
+    touchBit(dir);
+    return (v0 | (v1 << 1) | (dir ? 4 : 0));
+}
+
 #define __UPDATE_DISCREPANCY() \
     (memcpy(_lsrch, id, sizeof(Id)), ((_lzero = lzero) < 0))
 
-OneWireNg::ErrorCode OneWireNg::search(Id& id, bool alarm)
+/**
+ * Single pass of the search-scan process: reset, search command and 64 search
+ * triplets. In case of success @c id is written with the detected slave id
+ * (with not checked CRC) and @c lzero with the last 0-value discrepancy bit
+ * number. The search state is not updated in this case.
+ *
+ * Slave devices with filtered out family codes are skipped by the routine
+ * (which may require restarting the pass).
+ *
+ * If @c known table of @c n ids is provided, the pass is finished before
+ * the CRC part of the id if the already read part matches one of the known
+ * ids (CRC is determined by the preceding part of the id, therefore it may
+ * not differ for the matching slaves). Index of the matching id is written
+ * into @c kidx (-1 if not matched).
+ *
+ * @return Error codes: @c EC_SUCCESS, @c EC_NO_DEVS, @c EC_BUS_ERROR.
+ */
+OneWireNg::ErrorCode OneWireNg::searchPass(Id& id, bool alarm, int& lzero,
+    const Id *known, size_t n_known, int *kidx)
 {
 #if (CONFIG_MAX_SRCH_FILTERS > 0)
 restart:
 #endif
-    int lzero = -1;
+    lzero = -1;
     memset(&id, 0, sizeof(Id));
 
     /* initialize search process on slave devices */
@@ -70,10 +103,24 @@ restart:
 #if (CONFIG_MAX_SRCH_FILTERS > 0)
     searchFilterSelectAll();
 #endif
-    touchByte(alarm ? CMD_SEARCH_ROM_COND : CMD_SEARCH_ROM);
+    writeByte(alarm ? CMD_SEARCH_ROM_COND : CMD_SEARCH_ROM);
+
+    if (kidx)
+        *kidx = -1;
 
     for (int n=0; n < (int)(8*sizeof(Id)); n++)
     {
+        if (known && n == (int)(8*(sizeof(Id)-1)))
+        {
+            for (size_t i=0; i < n_known; i++) {
+                if (!memcmp(&known[i], &id, sizeof(Id)-1)) {
+                    id[sizeof(Id)-1] = known[i][sizeof(Id)-1];
+                    *kidx = (int)i;
+                    return EC_SUCCESS;
+                }
+            }
+        }
+
         ErrorCode ec = transmitSearchTriplet(n, id, lzero);
 
 #if (CONFIG_MAX_SRCH_FILTERS > 0)
@@ -84,9 +131,26 @@ restart:
                 goto restart;
         } else
 #endif
-        if (ec != EC_SUCCESS)
+        if (ec != EC_SUCCESS) {
+            /*
+             * No response for the 1st bit of the alarm search means there
+             * is no devices in the alarm state (not a bus error).
+             */
+            if (alarm && !n && ec == EC_BUS_ERROR)
+                return EC_NO_DEVS;
             return ec;
+        }
     }
+    return EC_SUCCESS;
+}
+
+OneWireNg::ErrorCode OneWireNg::search(Id& id, bool alarm)
+{
+    int lzero;
+
+    ErrorCode err = searchPass(id, alarm, lzero);
+    if (err != EC_SUCCESS)
+        return err;
 
     err = checkCrcId(id);
     if (err != EC_SUCCESS)
@@ -95,6 +159,102 @@ restart:
     return (__UPDATE_DISCREPANCY() ? EC_DONE : EC_MORE);
 }
 
+OneWireNg::ErrorCode OneWireNg::searchAll(
+    Id *ids, size_t max, size_t *found, bool alarm)
+{
+    ErrorCode ret = EC_SUCCESS;
+    size_t n = 0;
+
+    searchReset();
+    while (n < max)
+    {
+        Id& id = ids[n];
+        int lzero;
+
+        ErrorCode err = searchPass(id, alarm, lzero);
+        if (err != EC_SUCCESS) {
+            /* no more devices if all the remaining ones have been filtered */
+            if (err != EC_NO_DEVS || !n)
+                ret = err;
+            break;
+        }
+
+        /*
+         * Slave with CRC error is reported but doesn't stop the process,
+         * since the search path the id has been read from is still valid.
+         */
+        if (checkCrcId(id) != EC_SUCCESS)
+            ret = EC_CRC_ERROR;
+        n++;
+
+        if (__UPDATE_DISCREPANCY())
+            break;
+        else
+        if (n >= max)
+            ret = EC_FULL;
+    }
+
+    if (!max) {
+        /* no room for ids; check if there are any devices to report */
+        Id id;
+        int lzero;
+
+        ErrorCode err = searchPass(id, alarm, lzero);
+        ret = (err == EC_SUCCESS ? EC_FULL : err);
+    }
+    if (found)
+        *found = n;
+    return ret;
+}
+
+OneWireNg::ErrorCode OneWireNg::searchDelta(
+    const Id *known, size_t n, bool *present,
+    Id *added, size_t max, size_t *n_added)
+{
+    ErrorCode ret = EC_SUCCESS;
+    size_t na = 0;
+    bool fnd = false;
+
+    for (size_t i=0; i < n; i++)
+        present[i] = false;
+
+    searchReset();
+    for (;;)
+    {
+        Id id;
+        int lzero, kidx;
+
+        ErrorCode err = searchPass(id, false, lzero, known, n, &kidx);
+        if (err != EC_SUCCESS) {
+            /* no more devices if all the remaining ones have been filtered */
+            if (err != EC_NO_DEVS || !fnd)
+                ret = err;
+            break;
+        }
+        fnd = true;
+
+        if (kidx >= 0) {
+            present[kidx] = true;
+        } else
+        {
+            /* slave outside of the known set; fully read id */
+            if (na < max) {
+                memcpy(&added[na++], &id, sizeof(Id));
+                if (checkCrcId(id) != EC_SUCCESS && ret == EC_SUCCESS)
+                    ret = EC_CRC_ERROR;
+            } else
+                ret = EC_FULL;
+        }
+
+        if (__UPDATE_DISCREPANCY())
+            break;
+    }
+
+    if (n_added)
+        *n_added = na;
+    return ret;
+}
+
 #undef __UPDATE_DISCREPANCY
 
 #define __BITMASK8(n)       ((uint8_t)(1 << ((n) & 7)))
@@ -170,8 +330,10 @@ void OneWireNg::searchFilterSelect(int n, int bit)
  * - bit 1: 0 present for this bit position (master reads, slave writes),
  * - bit 2: 1 present for this bit position (master reads, slave writes),
  * - bit 3: select slave with a given bit value (master writes, slave reads).
- *     This bit may not be transmitted in case it has no sense (no slave
- *     devices on the bus or bus error).
+ *     This bit is not transmitted in case there is no slave devices on the
+ *     bus.
+ *
+ * The triplet is transmitted by @ref touchTriplet().
  *
  * If selected bit value is 1 then the corresponding n-th bit in @c id is set
  * (the @id shall be initialized with 0).
@@ -184,9 +346,26 @@ void OneWireNg::searchFilterSelect(int n, int bit)
 OneWireNg::ErrorCode OneWireNg::transmitSearchTriplet(int n, Id& id, int& lzero)
 {
     int selBit; /* selected bit value */
+    int fltBit = 2;
+    int dir;
 
-    int v0 = touchBit(1);   /* 0-presence */
-    int v1 = touchBit(1);   /* 1-presence */
+#if (CONFIG_MAX_SRCH_FILTERS > 0)
+    if (n < 8)
+        fltBit = searchFilterApply(n);
+#endif
+    /* direction taken in case of discrepancy */
+    if (fltBit != 2) {
+        dir = fltBit;
+    } else
+    if (n < _lzero) {
+        dir = (__BIT_IN_BYTE(_lsrch, n) != 0);
+    } else {
+        dir = (n == _lzero);
+    }
+
+    int trpl = touchTriplet(dir);
+    int v0 = trpl & 1;          /* 0-presence */
+    int v1 = (trpl >> 1) & 1;   /* 1-presence */
 
     if (v1 && v0)
     {
@@ -204,42 +383,23 @@ OneWireNg::ErrorCode OneWireNg::transmitSearchTriplet(int n, Id& id, int& lzero)
         if (n >= (int)(8*(sizeof(Id)-1))) {
             /* no discrepancy is expected for CRC part of the id - bus error */
             return EC_BUS_ERROR;
-        } else {
-#if (CONFIG_MAX_SRCH_FILTERS > 0)
-            if (n >= 8 || (selBit = searchFilterApply(n)) == 2)
-#endif
-            {
-                if (n < _lzero) {
-                    selBit = (__BIT_IN_BYTE(_lsrch, n) != 0);
-                } else
-                if (n == _lzero) {
-                    selBit = 1;
-                } else {
-                    selBit = 0;
-                }
-
-                if (!selBit)
-                    lzero = n;
-            }
         }
+
+        selBit = dir;
+        if (fltBit == 2 && !selBit)
+            lzero = n;
     } else
     {
         /*
          * Unambiguous value for this bit position.
          */
         selBit = !v1;
-#if (CONFIG_MAX_SRCH_FILTERS > 0)
-        if (n < 8)
-        {
-            /* check if code matches filtering criteria */
-            int fltBit = searchFilterApply(n);
-            if (fltBit != 2 && fltBit != selBit)
-                return EC_FILTERED;
-        }
-#endif
+
+        /* check if code matches filtering criteria */
+        if (fltBit != 2 && fltBit != selBit)
+            return EC_FILTERED;
     }
 
-    touchBit(selBit);
 #if (CONFIG_MAX_SRCH_FILTERS > 0)
     searchFilterSelect(n, selBit);
 #endif
@@ -254,49 +414,91 @@ OneWireNg::ErrorCode OneWireNg::transmitSearchTriplet(int n, Id& id, int& lzero)
 #undef __BYTE_OF_BIT
 #undef __BITMASK8
 
-uint8_t OneWireNg::crc8(const void *in, size_t len, uint8_t crc_in)
+/**
+ * CRC-8/MAXIM calculation by software (the configured algorithm).
+ */
+static uint8_t crc8Sw(const void *in, size_t len, uint8_t crc_in)
 {
     uint8_t crc = crc_in;
 
 #if (CONFIG_CRC8_ALGO == CRC8_TAB_16LH)
     const uint8_t *in_bts = (const uint8_t*)in;
 
-    static const uint8_t CRCTAB_STORAGE CRC8_16L[] = {
-        0x00, 0x5e, 0xbc, 0xe2, 0x61, 0x3f, 0xdd, 0x83,
-        0xc2, 0x9c, 0x7e, 0x20, 0xa3, 0xfd, 0x1f, 0x41
-    };
-    static const uint8_t CRCTAB_STORAGE CRC8_16H[] = {
-        0x00, 0x9d, 0x23, 0xbe, 0x46, 0xdb, 0x65, 0xf8,
-        0x8c, 0x11, 0xaf, 0x32, 0xca, 0x57, 0xe9, 0x74
-    };
+    const uint8_t *CRC8_16L = CrcTab16LH<uint8_t, 0x8c>::tabL;
+    const uint8_t *CRC8_16H = CrcTab16LH<uint8_t, 0x8c>::tabH;
 
     while (len--) {
         crc ^= *in_bts++;
         crc = tabRead_u8(CRC8_16L + (crc & 0x0f)) ^
             tabRead_u8(CRC8_16H + (crc >> 4));
     }
+#elif (CONFIG_CRC8_ALGO == CRC8_TAB_256 || \
+    CONFIG_CRC8_ALGO == CRC8_SLICING_BY_4)
+    const uint8_t *in_bts = (const uint8_t*)in;
+
+    const uint8_t *CRC8_256[] = {
+        CrcTab256<uint8_t, 0x8c, 0>::tab,
+# if (CONFIG_CRC8_ALGO == CRC8_SLICING_BY_4)
+        CrcTab256<uint8_t, 0x8c, 1>::tab,
+        CrcTab256<uint8_t, 0x8c, 2>::tab,
+        CrcTab256<uint8_t, 0x8c, 3>::tab
+# endif
+    };
+
+# if (CONFIG_CRC8_ALGO == CRC8_SLICING_BY_4)
+    for (; len >= 4; len -= 4, in_bts += 4) {
+        crc = tabRead_u8(&CRC8_256[3][crc ^ in_bts[0]]) ^
+            tabRead_u8(&CRC8_256[2][in_bts[1]]) ^
+            tabRead_u8(&CRC8_256[1][in_bts[2]]) ^
+            tabRead_u8(&CRC8_256[0][in_bts[3]]);
+    }
+# endif
+    while (len--)
+        crc = tabRead_u8(&CRC8_256[0][crc ^ *in_bts++]);
 #else
     crc = OneWireNg::crc<uint8_t, 0x8c>(in, len, crc);
 #endif
     return crc;
 }
 
+/* CRC-8/MAXIM folding constants (x^191 mod P, x^127 mod P; bit-reflected) */
+#define CRC8_FOLD_K1 0x9200000000000000ULL
+#define CRC8_FOLD_K2 0x8000000000000000ULL
+
+uint8_t OneWireNg::crc8(const void *in, size_t len, uint8_t crc_in)
+{
+#if defined(PLATFORM_CRC8)
+    return platformCrc8(in, len, crc_in);
+#else
+# ifdef PLATFORM_CRC_FOLD
+    uint8_t fld[16];
+    size_t n = platformCrcFold(
+        in, len, crc_in, CRC8_FOLD_K1, CRC8_FOLD_K2, fld);
+
+    if (n) {
+        /* CRC of the folded part; the rest calculated by software */
+        crc_in = crc8Sw(fld, sizeof(fld), 0);
+        in = (const uint8_t*)in + n;
+        len -= n;
+    }
+# endif
+    return crc8Sw(in, len, crc_in);
+#endif
+}
+
 #ifdef CONFIG_CRC16_ENABLED
-uint16_t OneWireNg::crc16(const void *in, size_t len, uint16_t crc_in)
+/**
+ * CRC-16/ARC calculation by software (the configured algorithm).
+ */
+static uint16_t crc16Sw(const void *in, size_t len, uint16_t crc_in)
 {
     uint16_t crc = crc_in;
 
-#if (CONFIG_CRC8_ALGO == CRC16_TAB_16LH)
+#if (CONFIG_CRC16_ALGO == CRC16_TAB_16LH)
     const uint8_t *in_bts = (const uint8_t*)in;
 
-    static const uint16_t CRCTAB_STORAGE CRC16_16L[] = {
-        0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241,
-        0xc601, 0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440
-    };
-    static const uint16_t CRCTAB_STORAGE CRC16_16H[] = {
-        0x0000, 0xcc01, 0xd801, 0x1400, 0xf001, 0x3c00, 0x2800, 0xe401,
-        0xa001, 0x6c00, 0x7800, 0xb401, 0x5000, 0x9c01, 0x8801, 0x4400
-    };
+    const uint16_t *CRC16_16L = CrcTab16LH<uint16_t, 0xa001>::tabL;
+    const uint16_t *CRC16_16H = CrcTab16LH<uint16_t, 0xa001>::tabH;
 
     while (len--) {
         crc ^= *in_bts++;
@@ -304,9 +506,68 @@ uint16_t OneWireNg::crc16(const void *in, size_t len, uint16_t crc_in)
             tabRead_u16(CRC16_16L + (crc & 0x0f)) ^
             tabRead_u16(CRC16_16H + ((crc >> 4) & 0x0f));
     }
+#elif (CONFIG_CRC16_ALGO == CRC16_TAB_256 || \
+    CONFIG_CRC16_ALGO == CRC16_SLICING_BY_8)
+    const uint8_t *in_bts = (const uint8_t*)in;
+
+    const uint16_t *CRC16_256[] = {
+        CrcTab256<uint16_t, 0xa001, 0>::tab,
+# if (CONFIG_CRC16_ALGO == CRC16_SLICING_BY_8)
+        CrcTab256<uint16_t, 0xa001, 1>::tab,
+        CrcTab256<uint16_t, 0xa001, 2>::tab,
+        CrcTab256<uint16_t, 0xa001, 3>::tab,
+        CrcTab256<uint16_t, 0xa001, 4>::tab,
+        CrcTab256<uint16_t, 0xa001, 5>::tab,
+        CrcTab256<uint16_t, 0xa001, 6>::tab,
+        CrcTab256<uint16_t, 0xa001, 7>::tab
+# endif
+    };
+
+# if (CONFIG_CRC16_ALGO == CRC16_SLICING_BY_8)
+    for (; len >= 8; len -= 8, in_bts += 8) {
+        crc ^= (uint16_t)in_bts[0] | ((uint16_t)in_bts[1] << 8);
+        crc = tabRead_u16(&CRC16_256[7][crc & 0xff]) ^
+            tabRead_u16(&CRC16_256[6][crc >> 8]) ^
+            tabRead_u16(&CRC16_256[5][in_bts[2]]) ^
+            tabRead_u16(&CRC16_256[4][in_bts[3]]) ^
+            tabRead_u16(&CRC16_256[3][in_bts[4]]) ^
+            tabRead_u16(&CRC16_256[2][in_bts[5]]) ^
+            tabRead_u16(&CRC16_256[1][in_bts[6]]) ^
+            tabRead_u16(&CRC16_256[0][in_bts[7]]);
+    }
+# endif
+    while (len--) {
+        crc = (crc >> 8) ^
+            tabRead_u16(&CRC16_256[0][(crc ^ *in_bts++) & 0xff]);
+    }
 #else
     crc = OneWireNg::crc<uint16_t, 0xa001>(in, len, crc_in);
 #endif
     return crc;
 }
+
+/* CRC-16/ARC folding constants (x^191 mod P, x^127 mod P; bit-reflected) */
+#define CRC16_FOLD_K1 0xccd0000000000000ULL
+#define CRC16_FOLD_K2 0xc100000000000000ULL
+
+uint16_t OneWireNg::crc16(const void *in, size_t len, uint16_t crc_in)
+{
+#if defined(PLATFORM_CRC16)
+    return platformCrc16(in, len, crc_in);
+#else
+# ifdef PLATFORM_CRC_FOLD
+    uint8_t fld[16];
+    size_t n = platformCrcFold(
+        in, len, crc_in, CRC16_FOLD_K1, CRC16_FOLD_K2, fld);
+
+    if (n) {
+        /* CRC of the folded part; the rest calculated by software */
+        crc_in = crc16Sw(fld, sizeof(fld), 0);
+        in = (const uint8_t*)in + n;
+        len -= n;
+    }
+# endif
+    return crc16Sw(in, len, crc_in);
+#endif
+}
 #endif
@@ -183,6 +183,23 @@ public:
             bytes[i] = touchByte(0xff);
     }
 
+    /**
+     * Search triplet touch. Read 2 bits (0 and 1 presence of the searched
+     * devices' id bits at the current position) and write the direction
+     * bit selecting devices to continue the search with. The direction is
+     * the presence of 1 if only one bit value is present, @c dir otherwise
+     * (discrepancy). The direction bit is not written if none of the bit
+     * values is present (no devices).
+     *
+     * @return Bits: 0 - 1st read bit, 1 - 2nd read bit, 2 - written
+     *     direction.
+     *
+     * @note This method is part of the extended virtual interface.
+     *     It may be overridden by bus masters performing the triplet
+     *     by a single command (e.g. DS2482).
+     */
+    EXT_VIRTUAL_INTF int touchTriplet(int dir);
+
     /**
      * Perform single search step in the search-scan process to detect slave
      * devices connected to the bus. Before calling this routine for the first
@@ -201,8 +218,9 @@ public:
      *     - @c EC_DONE (aka @c EC_SUCCESS): No more devices available.
      *         @c id is written with slave id.
      *     - @c EC_NO_DEVS: No slave devices (@c id not returned - undefined).
-     *         The code may be returned in 2 cases:
+     *         The code may be returned in 3 cases:
      *         - No devices detected on the bus,
+     *         - No devices in the alarm state (for @c alarm set to @c true),
      *         - No more devices available. Returned only if search filtering
      *           is enabled and slave ids detected at the last search step have
      *           been all filtered out (therefore @c EC_DONE doesn't apply).
@@ -214,6 +232,77 @@ public:
      */
     EXT_VIRTUAL_INTF ErrorCode search(Id& id, bool alarm = false);
 
+    /**
+     * Perform the whole search-scan process in a single call and write ids
+     * of all detected slave devices into the @c ids table. The routine resets
+     * the search state before the process.
+     *
+     * Contrary to a loop of @ref search() calls, a slave detected with CRC
+     * error doesn't abort the process. Its id is written into the table and
+     * the process continues for the remaining slaves.
+     *
+     * @param ids Table the ids of detected slave devices are written into.
+     * @param max Max. number of ids the @c ids table is able to hold.
+     * @param found If not @c NULL, written with the number of ids written
+     *     into the @c ids table.
+     * @param alarm If @c true - search for devices only with alarm state set,
+     *     @c false - search for all devices.
+     *
+     * @return
+     *     - @c EC_SUCCESS: All devices detected; their ids written into
+     *         the @c ids table.
+     *     - @c EC_NO_DEVS: No slave devices.
+     *     - @c EC_CRC_ERROR: All devices detected, but some of the written ids
+     *         have CRC error. Use @ref checkCrcId() to check particular id.
+     *     - @c EC_FULL: The @c ids table is full and there are more devices
+     *         available. The written ids may contain CRC errors.
+     *     - @c EC_BUS_ERROR: Bus error. The process has been aborted; ids
+     *         detected before the error are written into the table.
+     *
+     * @note For @c max equal 0 a single search pass is performed to check
+     *     for devices; @c EC_FULL is returned if any is detected.
+     */
+    ErrorCode searchAll(
+        Id *ids, size_t max, size_t *found = NULL, bool alarm = false);
+
+    /**
+     * Perform the search-scan process against the table of @c known ids
+     * (e.g. detected by a previous search) to find out differences between
+     * the known set of slaves and the slaves currently connected to the bus.
+     * The routine resets the search state before the process.
+     *
+     * Slaves from the known set are verified by the search process, but their
+     * ids are not read in whole - the search pass is finished before the CRC
+     * part of the id, which is determined by the already read part. Slaves
+     * removed from the bus don't incur any bus activity. Only slaves outside
+     * of the known set (the search tree branches not expected by the known
+     * set) are read in whole.
+     *
+     * @param known Table of known ids.
+     * @param n Number of ids in the @c known table.
+     * @param present Table of @c n flags written with the presence of
+     *     the corresponding known slave on the bus.
+     * @param added Table the ids of slaves outside of the known set are
+     *     written into.
+     * @param max Max. number of ids the @c added table is able to hold.
+     * @param n_added If not @c NULL, written with the number of ids written
+     *     into the @c added table.
+     *
+     * @return
+     *     - @c EC_SUCCESS: Process finished with success. The differences are
+     *         reported by @c present and @c added tables.
+     *     - @c EC_NO_DEVS: No slave devices.
+     *     - @c EC_CRC_ERROR: Process finished, but some of the ids written into
+     *         the @c added table have CRC error (use @ref checkCrcId()).
+     *     - @c EC_FULL: Process finished, but not all of the slaves outside of
+     *         the known set fit the @c added table.
+     *     - @c EC_BUS_ERROR: Bus error. The process has been aborted.
+     *
+     * @note Search filters apply to the process.
+     */
+    ErrorCode searchDelta(const Id *known, size_t n, bool *present,
+        Id *added, size_t max, size_t *n_added = NULL);
+
     /**
      * Reset 1-wire search state for a subsequent search-scan process.
      *
@@ -456,6 +545,24 @@ public:
         return EC_UNSUPPORED;
     }
 
+    /**
+     * Write a byte and power the 1-wire bus right after its last bit slot
+     * (e.g. function command of a parasitically powered slave device, which
+     * starts the energy consuming operation). Powering is the same as for
+     * @ref powerBus().
+     *
+     * By default the routine writes the byte and calls @ref powerBus()
+     * afterwards. Services which need the powering to be armed before the
+     * byte is transmitted (e.g. 1-wire bridges with the strong pull-up)
+     * override the routine.
+     *
+     * @return Error codes as for @ref powerBus().
+     */
+    virtual ErrorCode writeBytePwr(uint8_t byte) {
+        writeByte(byte);
+        return powerBus(true);
+    }
+
     /**
      * Generic CRC-8/16/32 calculation.
      *
@@ -529,6 +636,124 @@ public:
         return (crc == id[sizeof(Id)-1] ? EC_SUCCESS : EC_CRC_ERROR);
     }
 
+    /**
+     * CRC-8/MAXIM incremental calculation context.
+     *
+     * The context allows to calculate the CRC over data transferred in
+     * chunks (e.g. memory pages read by subsequent bulk reads), e.g.:
+     *
+     * @code
+     *     OneWireNg::Crc8Ctx crc;
+     *     for (size_t i = 0; i < pages; i++) {
+     *         ow.readBytes(page, sizeof(page));
+     *         crc.update(page, sizeof(page));
+     *     }
+     *     ec = crc.check(ow.readByte());
+     * @endcode
+     *
+     * @note Don't split a bulk read into single bytes to feed the context;
+     *     for data read by a single transfer use @ref crc8() on the buffer.
+     */
+    class Crc8Ctx
+    {
+    public:
+        Crc8Ctx(uint8_t crc_in = 0): _crc(crc_in) {}
+
+        /** Restart the calculation. */
+        void reset(uint8_t crc_in = 0) {
+            _crc = crc_in;
+        }
+
+        /** Update the CRC with @c len bytes of input @c in. */
+        void update(const void *in, size_t len) {
+            _crc = crc8(in, len, _crc);
+        }
+
+        /** Update the CRC with a single @c byte. */
+        void update(uint8_t byte) {
+            _crc = crc8(&byte, 1, _crc);
+        }
+
+        /** Get the CRC of the input passed so far. */
+        uint8_t final() const {
+            return _crc;
+        }
+
+        /**
+         * Check the calculated CRC against @c crc (as sent over the bus).
+         * @return Error codes:
+         *     - @c EC_SUCCESS: Compliant CRC.
+         *     - @c EC_CRC_ERROR: CRC mismatch.
+         */
+        ErrorCode check(uint8_t crc) const {
+            return (_crc == crc ? EC_SUCCESS : EC_CRC_ERROR);
+        }
+
+    private:
+        uint8_t _crc;
+    };
+
+#ifdef CONFIG_CRC16_ENABLED
+    /**
+     * CRC-16/ARC incremental calculation context.
+     * @see Crc8Ctx
+     */
+    class Crc16Ctx
+    {
+    public:
+        Crc16Ctx(uint16_t crc_in = 0): _crc(crc_in) {}
+
+        /** Restart the calculation. */
+        void reset(uint16_t crc_in = 0) {
+            _crc = crc_in;
+        }
+
+        /** Update the CRC with @c len bytes of input @c in. */
+        void update(const void *in, size_t len) {
+            _crc = crc16(in, len, _crc);
+        }
+
+        /** Update the CRC with a single @c byte. */
+        void update(uint8_t byte) {
+            _crc = crc16(&byte, 1, _crc);
+        }
+
+        /** Get the CRC of the input passed so far. */
+        uint16_t final() const {
+            return _crc;
+        }
+
+        /**
+         * Check the calculated CRC against @c crc.
+         * @return Error codes:
+         *     - @c EC_SUCCESS: Compliant CRC.
+         *     - @c EC_CRC_ERROR: CRC mismatch.
+         */
+        ErrorCode check(uint16_t crc) const {
+            return (_crc == crc ? EC_SUCCESS : EC_CRC_ERROR);
+        }
+
+        /**
+         * Check the calculated CRC against bitwise inverted CRC @c invCrc
+         * sent over the bus (see @ref checkInvCrc16()), e.g.:
+         *
+         * @code
+         *     ec = crc.checkInv(OneWireNg::getLSB_u16(&recv_buf[crc_offset]));
+         * @endcode
+         *
+         * @return Error codes:
+         *     - @c EC_SUCCESS: Compliant CRC.
+         *     - @c EC_CRC_ERROR: CRC mismatch.
+         */
+        ErrorCode checkInv(uint16_t invCrc) const {
+            return (!(uint16_t)(_crc ^ ~invCrc) ? EC_SUCCESS : EC_CRC_ERROR);
+        }
+
+    private:
+        uint16_t _crc;
+    };
+#endif
+
     /**
      * Read 2 consecutive bytes starting at address @c addr and interpret them
      * as @c uin16_t little-endian integer.
@@ -632,6 +857,8 @@ protected:
 #endif
 
 private:
+    ErrorCode searchPass(Id& id, bool alarm, int& lzero,
+        const Id *known = NULL, size_t n_known = 0, int *kidx = NULL);
     ErrorCode transmitSearchTriplet(int n, Id& id, int& lzero);
 
     Id _lsrch;  /** last search result */
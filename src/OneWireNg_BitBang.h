@@ -13,7 +13,7 @@
 #ifndef __OWNG_BITBANG__
 #define __OWNG_BITBANG__
 
-#include "OneWireNg.h"
+#include "OneWireNg_BitBangT.h"
 
 /**
  * GPIO bit-banged implementation of 1-wire bus activities: reset, touch,
@@ -28,30 +28,17 @@
  * and optionally:
  * - @ref touch1Overdrive(): if overdrive mode is enabled and requires specific
  *       implementation.
+ *
+ * @note The library platform classes base on @ref OneWireNg_BitBangT, which
+ *     calls the GPIO routines directly (no virtual calls overhead on the
+ *     time critical paths). This class is intended for GPIO implementations
+ *     requiring run-time polymorphism.
  */
-class OneWireNg_BitBang: public OneWireNg
+class OneWireNg_BitBang: public OneWireNg_BitBangT<OneWireNg_BitBang>
 {
-public:
-    ErrorCode reset();
-    int touchBit(int bit);
-
-    /**
-     * Enable/disable direct voltage source provisioning on the 1-wire data bus
-     * parasitically powering connected slave devices. In case of open-drain
-     * type of platform, where no power-control-GPIO has been configured,
-     * the routine returns @c EC_UNSUPPORED, @c EC_SUCCESS.
-     *
-     * @see setupPwrCtrlGpio().
-     */
-    ErrorCode powerBus(bool on);
+    friend class OneWireNg_BitBangT<OneWireNg_BitBang>;
 
 protected:
-    typedef enum
-    {
-        GPIO_DTA = 0,   /** 1-wire data GPIO */
-        GPIO_CTRL_PWR   /** power-control-GPIO */
-    } GpioType;
-
     /**
      * This class is intended to be inherited by specialized classes.
      *
@@ -60,41 +47,8 @@ protected:
      *
      * @see writeGpioOut().
      */
-    OneWireNg_BitBang(bool openDrain = false)
-    {
-        _flgs.od = (openDrain != 0);
-        _flgs.pwre = 0;
-        _flgs.pwrp = 0;
-        _flgs.pwrr = 0;
-    }
-
-    /**
-     * For open-drain type of platform data bus GPIO can't serve as a voltage
-     * source for parasitically power connected slaves. This routine enables /
-     * disables power-control-GPIO (working in the output mode) controlling
-     * power switching transistor providing the voltage source to the bus.
-     * The GPIO is set to the low state in case the power is enabled on the
-     * bus via @ref powerBus() routine and to the high state otherwise. The
-     * logic may be inverted by setting @c reversePolarity to @c true.
-     */
-    void setupPwrCtrlGpio(bool on, bool reversePolarity = false)
-    {
-        if (on) {
-            _flgs.pwrr = (reversePolarity != 0);
-            setGpioAsOutput(GPIO_CTRL_PWR, (reversePolarity ? 0 : 1));
-            _flgs.pwrp = 1;
-        } else {
-            _flgs.pwrp = 0;
-        }
-    }
-
-    /**
-     * Utility routine. Shall be called from inheriting class to initialize
-     * data GPIO.
-     */
-    void setupDtaGpio() {
-        setBus(1);
-    }
+    OneWireNg_BitBang(bool openDrain = false):
+        OneWireNg_BitBangT<OneWireNg_BitBang>(openDrain) {}
 
     /**
      * Read input-mode @c gpio and return its state (0: low, 1: high).
@@ -165,28 +119,6 @@ protected:
     virtual int touch1Overdrive();
 #endif
 
-    /**
-     * Set 1-wire data bus state: high (1) or low (0).
-     */
-    void setBus(int state)
-    {
-        if (state) {
-#ifdef CONFIG_BUS_BLINK_PROTECTION
-            writeGpioOut(GPIO_DTA, 1);
-#endif
-            setGpioAsInput(GPIO_DTA);
-        } else {
-            setGpioAsOutput(GPIO_DTA, 0);
-        }
-    }
-
-    struct {
-        unsigned od:   1;   /** open drain indicator */
-        unsigned pwre: 1;   /** bus is powered indicator */
-        unsigned pwrp: 1;   /** power-control-GPIO pin is valid */
-        unsigned pwrr: 1;   /** power-control-GPIO works in reverse polarity */
-    } _flgs;
-
 #ifdef __TEST__
 friend class OneWireNg_BitBang_Test;
 #endif
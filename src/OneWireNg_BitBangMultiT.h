@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __OWNG_BITBANG_MULTI_T__
+#define __OWNG_BITBANG_MULTI_T__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "OneWireNg_Config.h"
+#include "OneWireNg_Timings.h"
+#include "platform/Platform_Delay.h"
+#include "platform/Platform_TimeCritical.h"
+
+/**
+ * GPIO bit-banged implementation of up to 8 independent 1-wire buses driven
+ * in parallel (port-parallel bit-banging).
+ *
+ * All the buses' data GPIOs shall belong to the same GPIO port, so they may
+ * be set and sampled by a single port register access. Reset, write and
+ * read slots are issued on the selected buses at once, therefore broadcast
+ * activities (e.g. temperature conversion on all sensors) and per-bus reads
+ * take the same time as for a single bus.
+ *
+ * The buses are selected by @ref BusMask bitmaps (n-th bit denotes n-th bus
+ * as added by @ref addBus()). Per-bus data is passed in tables of @c len
+ * bytes per each bus, n-th bus data is located at offset @c n*len.
+ *
+ * The class template is parametrized by the platform class @c Port deriving
+ * from it (CRTP) and the port register type @c Mask. The platform class
+ * provides the port operations (performed on GPIOs set in the mask):
+ * - @c Mask readPortIn(): Read port GPIOs state.
+ * - @c void setPortAsInput(Mask m): Set GPIOs in the input mode (releasing
+ *   the buses).
+ * - @c void setPortAsOutput(Mask m, int state): Set GPIOs in the output
+ *   mode with the given state.
+ *
+ * @note Only the standard mode is supported. The buses powering is supported
+ *     via switching their GPIOs to the high state.
+ */
+template<class Port, class Mask>
+class OneWireNg_BitBangMultiT
+{
+public:
+    /** Bitmap of buses (n-th bit denotes n-th bus) */
+    typedef uint8_t BusMask;
+
+    /** Max. number of supported buses */
+    const static int MAX_BUSES = 8;
+
+    /** All buses */
+    const static BusMask ALL_BUSES = 0xff;
+
+    /**
+     * Get number of handled buses.
+     */
+    int getBusesNum() {
+        return _busNum;
+    }
+
+    /**
+     * Reset the selected @c buses.
+     *
+     * @return Bitmap of the selected buses with slave devices presence
+     *     detected.
+     */
+    BusMask reset(BusMask buses = ALL_BUSES);
+
+    /**
+     * Touch single bit on the selected @c buses. Bit value for n-th bus is
+     * taken from n-th bit of @c bits.
+     *
+     * @return Bitmap of the touched bits read from the selected buses.
+     */
+    BusMask touchBit(BusMask buses, BusMask bits);
+
+    /**
+     * Touch @c len bytes per each of the selected @c buses. The bytes of
+     * n-th bus are located in @c bytes table at offset @c n*len and are
+     * replaced by the touched (read) bytes.
+     */
+    void touchBytes(BusMask buses, uint8_t *bytes, size_t len) {
+        touchBytesEng(buses, bytes, len, bytes, len);
+    }
+
+    /**
+     * Write the same @c len bytes on the selected @c buses (broadcast).
+     */
+    void writeBytes(BusMask buses, const uint8_t *bytes, size_t len) {
+        touchBytesEng(buses, bytes, 0, NULL, len);
+    }
+
+    /**
+     * Write the same @c byte on the selected @c buses (broadcast).
+     */
+    void writeByte(BusMask buses, uint8_t byte) {
+        touchBytesEng(buses, &byte, 0, NULL, 1);
+    }
+
+    /**
+     * Read @c len bytes from each of the selected @c buses. The bytes read
+     * from n-th bus are written into @c bytes table at offset @c n*len.
+     */
+    void readBytes(BusMask buses, uint8_t *bytes, size_t len) {
+        touchBytesEng(buses, NULL, 0, bytes, len);
+    }
+
+    /**
+     * Enable/disable direct voltage source provisioning on the selected
+     * @c buses (via their GPIOs set to the high state). The powering is
+     * disabled on the next activity on any of the buses.
+     */
+    void powerBus(BusMask buses, bool on)
+    {
+        Mask pins = toPins(buses);
+
+        if (on) {
+            port().setPortAsOutput(pins, 1);
+            _pwrMsk |= pins;
+        } else {
+            port().setPortAsInput(pins);
+            _pwrMsk &= ~pins;
+        }
+    }
+
+protected:
+    /**
+     * This class is intended to be inherited by specialized classes.
+     */
+    OneWireNg_BitBangMultiT(): _busNum(0), _pwrMsk(0) {}
+
+    /**
+     * Utility routine. Shall be called from inheriting class to add a bus
+     * with data GPIO @c pin (port's bit mask) and release the bus.
+     *
+     * @return Index of the added bus or -1 if there is no space for it.
+     */
+    int addBus(Mask pin)
+    {
+        if (_busNum >= MAX_BUSES)
+            return -1;
+
+        _busMsk[_busNum] = pin;
+        port().setPortAsInput(pin);
+        return _busNum++;
+    }
+
+    /**
+     * Convert bitmap of buses into the port's GPIOs mask.
+     */
+    Mask toPins(BusMask buses)
+    {
+        Mask pins = 0;
+        for (int i = 0; i < _busNum; i++) {
+            if (buses & (1 << i))
+                pins |= _busMsk[i];
+        }
+        return pins;
+    }
+
+    /**
+     * Convert port's GPIOs mask into bitmap of buses.
+     */
+    BusMask toBuses(Mask pins)
+    {
+        BusMask buses = 0;
+        for (int i = 0; i < _busNum; i++) {
+            if (pins & _busMsk[i])
+                buses |= (BusMask)(1 << i);
+        }
+        return buses;
+    }
+
+    /**
+     * Bytes touching engine. Touch @c len bytes on the selected @c buses.
+     * Bytes of n-th bus are taken from @c in at offset @c n*inStride
+     * (@c 0xff bytes are touched if @c NULL) and written into @c out at
+     * offset @c n*len (the result is not stored if @c NULL).
+     */
+    void touchBytesEng(BusMask buses, const uint8_t *in, size_t inStride,
+        uint8_t *out, size_t len);
+
+    /**
+     * Touch single bit in standard mode: write-1 slot on @c ones GPIOs and
+     * write-0 slot on @c zeros GPIOs, both issued at once.
+     *
+     * @return Port's GPIOs state sampled at the write-1 slot sampling time.
+     */
+    Mask touchBitStd(Mask ones, Mask zeros);
+
+    Mask _busMsk[MAX_BUSES];    /** buses data GPIOs masks */
+    int _busNum;                /** number of buses */
+    Mask _pwrMsk;               /** powered buses GPIOs mask */
+
+private:
+    Port& port() {
+        return *static_cast<Port*>(this);
+    }
+
+    void unpower()
+    {
+        if (_pwrMsk) {
+            port().setPortAsInput(_pwrMsk);
+            _pwrMsk = 0;
+        }
+    }
+};
+
+template<class Port, class Mask>
+TIME_CRITICAL typename OneWireNg_BitBangMultiT<Port, Mask>::BusMask
+    OneWireNg_BitBangMultiT<Port, Mask>::reset(BusMask buses)
+{
+    Mask pins = toPins(buses), smpl;
+
+    unpower();
+
+    port().setPortAsOutput(pins, 0);
+    delayUs(STD_RESET_LOW);
+    timeCriticalEnter();
+    port().setPortAsInput(pins);
+    delayUs(STD_RESET_SMPL);
+    smpl = port().readPortIn();
+    timeCriticalExit();
+    delayUs(STD_RESET_END);
+
+    /* presence pulse pulls the bus low */
+    return toBuses(pins & ~smpl);
+}
+
+template<class Port, class Mask>
+TIME_CRITICAL Mask OneWireNg_BitBangMultiT<Port, Mask>::touchBitStd(
+    Mask ones, Mask zeros)
+{
+    Mask smpl;
+
+    timeCriticalEnter();
+    port().setPortAsOutput(ones | zeros, 0);
+    delayUs(STD_WRITE1_LOW);
+    port().setPortAsInput(ones);
+    delayUs(STD_WRITE1_SMPL);
+    smpl = port().readPortIn();
+
+    if (zeros) {
+        /* write-0 slots are finished after the write-1 sampling */
+        delayUs(STD_WRITE0_LOW - STD_WRITE1_LOW - STD_WRITE1_SMPL);
+        port().setPortAsInput(zeros);
+        timeCriticalExit();
+        delayUs(STD_WRITE0_END);
+    } else {
+        timeCriticalExit();
+        delayUs(STD_WRITE1_END);
+    }
+    return smpl;
+}
+
+template<class Port, class Mask>
+typename OneWireNg_BitBangMultiT<Port, Mask>::BusMask
+    OneWireNg_BitBangMultiT<Port, Mask>::touchBit(BusMask buses, BusMask bits)
+{
+    unpower();
+
+    Mask ones = toPins(buses & bits);
+    Mask zeros = toPins(buses & ~bits);
+
+    return toBuses(touchBitStd(ones, zeros) & ones);
+}
+
+template<class Port, class Mask>
+void OneWireNg_BitBangMultiT<Port, Mask>::touchBytesEng(BusMask buses,
+    const uint8_t *in, size_t inStride, uint8_t *out, size_t len)
+{
+    unpower();
+
+    for (size_t i = 0; i < len; i++)
+    {
+        for (int j = 0; j < 8; j++)
+        {
+            Mask ones = 0, zeros = 0;
+
+            /* GPIOs masks are prepared between the slots */
+            for (int b = 0; b < _busNum; b++) {
+                if (!(buses & (1 << b)))
+                    continue;
+
+                if (!in || (in[b * inStride + i] & (1 << j))) {
+                    ones |= _busMsk[b];
+                } else {
+                    zeros |= _busMsk[b];
+                }
+            }
+
+            Mask smpl = touchBitStd(ones, zeros);
+
+            if (out) {
+                for (int b = 0; b < _busNum; b++) {
+                    if (!(buses & (1 << b)))
+                        continue;
+
+                    uint8_t *o = &out[b * len + i];
+                    if (smpl & ones & _busMsk[b]) {
+                        *o = (uint8_t)(*o | (1 << j));
+                    } else {
+                        *o = (uint8_t)(*o & ~(1 << j));
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif /* __OWNG_BITBANG_MULTI_T__ */
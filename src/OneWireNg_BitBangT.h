@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2019-2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __OWNG_BITBANG_T__
+#define __OWNG_BITBANG_T__
+
+#include "OneWireNg.h"
+#include "OneWireNg_Timings.h"
+#include "platform/Platform_Delay.h"
+#include "platform/Platform_TimeCritical.h"
+
+/**
+ * GPIO bit-banged implementation of 1-wire bus activities: reset, touch,
+ * parasite powering.
+ *
+ * The class template is parametrized by the platform class @c Gpio deriving
+ * from it (CRTP), which provides GPIO operations:
+ * - @c readGpioIn(), @c writeGpioOut(): read/write operations.
+ * - @c setGpioAsInput(), @c setGpioAsOutput(): set GPIO working mode.
+ *
+ * and optionally @c touch1Overdrive() (see @ref OneWireNg_BitBang for the
+ * routines specification). The routines are called directly (not via virtual
+ * calls), therefore they may be inlined by the compiler into the bit-banging
+ * code. If the routines are not public, the platform class shall declare
+ * @c OneWireNg_BitBangT<Gpio> as its friend:
+ *
+ * @code
+ * class OneWireNg_MyPlatform: public OneWireNg_BitBangT<OneWireNg_MyPlatform>
+ * {
+ *     friend class OneWireNg_BitBangT<OneWireNg_MyPlatform>;
+ *     // ...
+ * protected:
+ *     int readGpioIn(GpioType gpio) { ... }
+ *     // ...
+ * };
+ * @endcode
+ *
+ * Byte and multi-byte touching routines are implemented by the class with
+ * the bus powering and overdrive mode checks performed once per call (not
+ * for each touched bit). The routines are used by the library core (e.g.
+ * search, addressing) and the device drivers if the extended virtual
+ * interface is enabled (@ref CONFIG_EXT_VIRTUAL_INTF), otherwise only if
+ * called directly on the class object.
+ *
+ * @see OneWireNg_BitBang for the GPIO interface implemented by virtual
+ *     functions.
+ */
+template<class Gpio>
+class OneWireNg_BitBangT: public OneWireNg
+{
+public:
+    ErrorCode reset();
+    int touchBit(int bit);
+
+    uint8_t touchByte(uint8_t byte) {
+        uint8_t ret;
+        touchBytesEng(&byte, &ret, 1);
+        return ret;
+    }
+
+    void touchBytes(uint8_t *bytes, size_t len) {
+        touchBytesEng(bytes, bytes, len);
+    }
+
+    void writeByte(uint8_t byte) {
+        touchBytesEng(&byte, NULL, 1);
+    }
+
+    void writeBytes(const uint8_t *bytes, size_t len) {
+        touchBytesEng(bytes, NULL, len);
+    }
+
+    uint8_t readByte() {
+        uint8_t ret;
+        touchBytesEng(NULL, &ret, 1);
+        return ret;
+    }
+
+    void readBytes(uint8_t *bytes, size_t len) {
+        touchBytesEng(NULL, bytes, len);
+    }
+
+    /**
+     * Enable/disable direct voltage source provisioning on the 1-wire data bus
+     * parasitically powering connected slave devices. In case of open-drain
+     * type of platform, where no power-control-GPIO has been configured,
+     * the routine returns @c EC_UNSUPPORED, @c EC_SUCCESS.
+     *
+     * @see setupPwrCtrlGpio().
+     */
+    ErrorCode powerBus(bool on);
+
+protected:
+    typedef enum
+    {
+        GPIO_DTA = 0,   /** 1-wire data GPIO */
+        GPIO_CTRL_PWR   /** power-control-GPIO */
+    } GpioType;
+
+    /**
+     * This class is intended to be inherited by specialized classes.
+     *
+     * @param openDrain Set to @c true if platform's GPIOs are of open-drain
+     *    type (in the output mode).
+     */
+    OneWireNg_BitBangT(bool openDrain = false)
+    {
+        _flgs.od = (openDrain != 0);
+        _flgs.pwre = 0;
+        _flgs.pwrp = 0;
+        _flgs.pwrr = 0;
+    }
+
+    /**
+     * For open-drain type of platform data bus GPIO can't serve as a voltage
+     * source for parasitically power connected slaves. This routine enables /
+     * disables power-control-GPIO (working in the output mode) controlling
+     * power switching transistor providing the voltage source to the bus.
+     * The GPIO is set to the low state in case the power is enabled on the
+     * bus via @ref powerBus() routine and to the high state otherwise. The
+     * logic may be inverted by setting @c reversePolarity to @c true.
+     */
+    void setupPwrCtrlGpio(bool on, bool reversePolarity = false)
+    {
+        if (on) {
+            _flgs.pwrr = (reversePolarity != 0);
+            gpio().setGpioAsOutput(GPIO_CTRL_PWR, (reversePolarity ? 0 : 1));
+            _flgs.pwrp = 1;
+        } else {
+            _flgs.pwrp = 0;
+        }
+    }
+
+    /**
+     * Utility routine. Shall be called from inheriting class to initialize
+     * data GPIO.
+     */
+    void setupDtaGpio() {
+        setBus(1);
+    }
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+    /**
+     * Generic implementation of touch-1 in overdrive mode via the GPIO
+     * interface. Used unless the platform class provides its own one.
+     */
+    int touch1Overdrive();
+#endif
+
+    /**
+     * Set 1-wire data bus state: high (1) or low (0).
+     */
+    void setBus(int state)
+    {
+        if (state) {
+#ifdef CONFIG_BUS_BLINK_PROTECTION
+            gpio().writeGpioOut(GPIO_DTA, 1);
+#endif
+            gpio().setGpioAsInput(GPIO_DTA);
+        } else {
+            gpio().setGpioAsOutput(GPIO_DTA, 0);
+        }
+    }
+
+    /**
+     * Bytes touching engine. Touch @c len bytes from @c in (@c 0xff bytes
+     * are touched if @c NULL) and write the result into @c out (the result
+     * is not stored if @c NULL). @c in and @c out may point to the same
+     * buffer.
+     */
+    void touchBytesEng(const uint8_t *in, uint8_t *out, size_t len);
+
+    /**
+     * Touch single bit in standard mode.
+     * No bus powering nor overdrive mode checks are performed.
+     */
+    int touchBitStd(int bit);
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+    /**
+     * Touch single bit in overdrive mode.
+     * No bus powering nor overdrive mode checks are performed.
+     */
+    int touchBitOd(int bit);
+#endif
+
+    struct {
+        unsigned od:   1;   /** open drain indicator */
+        unsigned pwre: 1;   /** bus is powered indicator */
+        unsigned pwrp: 1;   /** power-control-GPIO pin is valid */
+        unsigned pwrr: 1;   /** power-control-GPIO works in reverse polarity */
+    } _flgs;
+
+private:
+    Gpio& gpio() {
+        return *static_cast<Gpio*>(this);
+    }
+};
+
+template<class Gpio>
+TIME_CRITICAL OneWireNg::ErrorCode OneWireNg_BitBangT<Gpio>::reset()
+{
+    int presPulse;
+
+    timeCriticalEnter();
+    if (_flgs.pwre) powerBus(false);
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+    if (_overdrive)
+    {
+        /* Overdrive mode
+         */
+        setBus(0);
+        delayUs(OD_RESET_LOW);
+        setBus(1);
+        delayUs(OD_RESET_SMPL);
+        presPulse = gpio().readGpioIn(GPIO_DTA);
+        timeCriticalExit();
+        delayUs(OD_RESET_END);
+    } else
+#endif
+    {
+        /* Standard mode
+         */
+        setBus(0);
+        timeCriticalExit();
+        delayUs(STD_RESET_LOW);
+        timeCriticalEnter();
+        setBus(1);
+        delayUs(STD_RESET_SMPL);
+        presPulse = gpio().readGpioIn(GPIO_DTA);
+        timeCriticalExit();
+        delayUs(STD_RESET_END);
+    }
+    return (presPulse ? EC_NO_DEVS : EC_SUCCESS);
+}
+
+template<class Gpio>
+TIME_CRITICAL int OneWireNg_BitBangT<Gpio>::touchBitStd(int bit)
+{
+    int smpl = 0;
+
+    timeCriticalEnter();
+    if (bit != 0)
+    {
+        /* write-1 with sampling (alias read) */
+        setBus(0);
+        delayUs(STD_WRITE1_LOW);
+        setBus(1);
+        delayUs(STD_WRITE1_SMPL);
+        smpl = gpio().readGpioIn(GPIO_DTA);
+        timeCriticalExit();
+        delayUs(STD_WRITE1_END);
+    } else
+    {
+        /* write-0 */
+        setBus(0);
+        delayUs(STD_WRITE0_LOW);
+        setBus(1);
+        timeCriticalExit();
+        delayUs(STD_WRITE0_END);
+    }
+    return smpl;
+}
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+template<class Gpio>
+TIME_CRITICAL int OneWireNg_BitBangT<Gpio>::touchBitOd(int bit)
+{
+    int smpl = 0;
+
+    timeCriticalEnter();
+    if (bit != 0)
+    {
+        /* write-1 with sampling (alias read) */
+        smpl = gpio().touch1Overdrive();
+        timeCriticalExit();
+        delayUs(OD_WRITE1_END);
+    } else
+    {
+        /* write-0 */
+        setBus(0);
+        delayUs(OD_WRITE0_LOW);
+        setBus(1);
+        timeCriticalExit();
+        delayUs(OD_WRITE0_END);
+    }
+    return smpl;
+}
+#endif
+
+template<class Gpio>
+TIME_CRITICAL int OneWireNg_BitBangT<Gpio>::touchBit(int bit)
+{
+    if (_flgs.pwre) powerBus(false);
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+    if (_overdrive)
+        return touchBitOd(bit);
+#endif
+    return touchBitStd(bit);
+}
+
+/*
+ * Touch bytes by bit touching routine @c touchBitFun.
+ */
+#define __TOUCH_BYTES(touchBitFun) \
+    for (size_t i = 0; i < len; i++) { \
+        uint8_t byte = (in ? in[i] : 0xff), ret = 0; \
+        for (int j = 0; j < 8; j++, byte >>= 1) { \
+            ret >>= 1; \
+            if (touchBitFun(byte & 1)) ret |= 0x80; \
+        } \
+        if (out) out[i] = ret; \
+    }
+
+template<class Gpio>
+TIME_CRITICAL void OneWireNg_BitBangT<Gpio>::touchBytesEng(
+    const uint8_t *in, uint8_t *out, size_t len)
+{
+    if (_flgs.pwre) powerBus(false);
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+    if (_overdrive) {
+        __TOUCH_BYTES(touchBitOd);
+    } else
+#endif
+    {
+        __TOUCH_BYTES(touchBitStd);
+    }
+}
+
+#undef __TOUCH_BYTES
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+template<class Gpio>
+int OneWireNg_BitBangT<Gpio>::touch1Overdrive()
+{
+    setBus(0);
+#if OD_WRITE1_LOW >= 0
+    delayUs(OD_WRITE1_LOW);
+#endif
+    /* speed up low-to-high transition */
+#ifndef CONFIG_BUS_BLINK_PROTECTION
+    gpio().writeGpioOut(GPIO_DTA, 1);
+#endif
+    setBus(1);
+#if OD_WRITE1_SMPL >= 0
+    delayUs(OD_WRITE1_SMPL);
+#endif
+    return gpio().readGpioIn(GPIO_DTA);
+}
+#endif
+
+template<class Gpio>
+OneWireNg::ErrorCode OneWireNg_BitBangT<Gpio>::powerBus(bool on)
+{
+    if (!_flgs.od) {
+        if (on) {
+            gpio().setGpioAsOutput(GPIO_DTA, 1);
+        } else {
+            gpio().setGpioAsInput(GPIO_DTA);
+        }
+    } else
+    if (_flgs.pwrp) {
+        gpio().writeGpioOut(GPIO_CTRL_PWR, (_flgs.pwrr ? (on != 0) : !on));
+    } else {
+        return EC_UNSUPPORED;
+    }
+    _flgs.pwre = (on != 0);
+    return EC_SUCCESS;
+}
+
+#endif /* __OWNG_BITBANG_T__ */
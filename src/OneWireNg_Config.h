@@ -25,6 +25,11 @@
  * @c CRC8_BASIC: Basic method. No memory tables used. This method is about 8
  *     times slower than the tabled method but no extra memory is used.
  * @c CRC8_TAB_16LH: 2x16 elements table, 1 byte each.
+ * @c CRC8_TAB_256: 256 elements table, 1 byte each. Single table lookup per
+ *     input byte (2 lookups for @c CRC8_TAB_16LH).
+ * @c CRC8_SLICING_BY_4: Slicing-by-4 method, 4x256 elements table, 1 byte
+ *     each. Processes 4 bytes per iteration; the fastest method for long
+ *     input data on platforms with fast memory access.
  */
 #define CONFIG_CRC8_ALGO CRC8_TAB_16LH
 
@@ -41,9 +46,24 @@
  * @c CRC16_BASIC: Basic method. No memory tables used. This method is about 8
  *     times slower than the tabled method but no extra memory is used.
  * @c CRC16_TAB_16LH: 2x16 elements table, 2 bytes each.
+ * @c CRC16_TAB_256: 256 elements table, 2 bytes each. Single table lookup per
+ *     input byte (2 lookups for @c CRC16_TAB_16LH).
+ * @c CRC16_SLICING_BY_8: Slicing-by-8 method, 8x256 elements table, 2 bytes
+ *     each. Processes 8 bytes per iteration; the fastest method for long
+ *     input data (e.g. memory pages) on platforms with fast memory access.
  */
 #define CONFIG_CRC16_ALGO CRC16_TAB_16LH
 
+/**
+ * Use platform specific CRC calculation engine (hardware CRC unit, CPU
+ * instructions dedicated for CRC calculation) if available for the target
+ * platform (see platform/Platform_Crc.h for supported platforms). For
+ * unsupported platforms, or in case the engine is used only for a part of
+ * the calculation, the algorithms configured by @ref CONFIG_CRC8_ALGO and
+ * @ref CONFIG_CRC16_ALGO are used.
+ */
+//#define CONFIG_PLATFORM_CRC
+
 /**
  * Store CRC tables in flash memory instead of RAM.
  * Valid only if CRC algorithms are configured for memory tables usage.
@@ -100,12 +120,38 @@
  *
  * The extended interface enables more advance 1-wire service drivers to be
  * implemented in the future. The penalty is additional overhead needed for
- * calling the virtual methods being part of this interface. Since current
- * implementation doesn't leverage the interface it's recommended to disable
- * this parameter for slower platforms.
+ * calling the virtual methods being part of this interface.
+ *
+ * If enabled, the byte touching routines of GPIO bit-banged drivers (see
+ * @ref OneWireNg_BitBang) are used by the library core and the device drivers
+ * (bus powering and overdrive mode are checked once per touched bytes, not
+ * for each bit). The gain is noticeable on slower platforms for longer
+ * transfers, but for short ones it may be neutralized by the virtual calls
+ * overhead.
  */
 //#define CONFIG_EXT_VIRTUAL_INTF
 
+/**
+ * UART 1-wire service (@ref OneWireNg_Uart) specific.
+ *
+ * Maximum number of bytes touched by a single UART burst. Each byte is
+ * transmitted as 8 UART characters (one per bit), therefore the service
+ * buffer is 8 times larger. Longer transfers are split into several bursts.
+ * If not defined 8 is assumed.
+ */
+#define CONFIG_UART_BURST_BYTES 8
+
+/**
+ * ESP32 RMT 1-wire service (@ref OneWireNg_ArduinoESP32_Rmt) specific.
+ *
+ * Maximum number of bytes touched by a single RMT burst. Each byte is
+ * transmitted as 8 RMT items (one per slot), which need to fit into the RX
+ * channel memory (2 memory blocks), therefore the value shall not exceed 8
+ * on ESP32-C3 and 12 on other ESP32 targets. Longer transfers are split into
+ * several bursts. If not defined 8 is assumed.
+ */
+#define CONFIG_ESP32_RMT_BURST_BYTES 8
+
 /**
  * Dallas thermometers specific.
  *
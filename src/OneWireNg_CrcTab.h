@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/*
+ * Compile time generated CRC tables.
+ *
+ * The tables are generated by the compiler for a CRC polynomial @c RevPoly
+ * (coefficients in reverse order, as for @ref OneWireNg::crc()), therefore
+ * no runtime initialization is needed. The tables are placed in flash memory
+ * if @ref CONFIG_FLASH_CRC_TAB is configured (use @c tabRead_XXX() routines
+ * to read the tables content).
+ *
+ * Example of table-driven CRC-16/MAXIM calculation:
+ *
+ *     uint16_t crc = ~crcTab256<uint16_t, 0xa001>(in, len, 0);
+ *
+ * @note The tables are generated by recursive templates (C++98 compliant),
+ *     therefore no C++11 support is required by the compiler.
+ */
+#ifndef __OWNG_CRC_TAB__
+#define __OWNG_CRC_TAB__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "OneWireNg_Config.h"
+
+#ifdef CONFIG_FLASH_CRC_TAB
+# include "platform/Platform_FlashMem.h"
+# define tabRead_u8 flashRead_u8
+# define tabRead_u16 flashRead_u16
+# define tabRead_u32 flashRead_u32
+#else
+# define CRCTAB_STORAGE
+# define tabRead_u8(addr) (*(const uint8_t*)(addr))
+# define tabRead_u16(addr) (*(const uint16_t*)(addr))
+# define tabRead_u32(addr) (*(const uint32_t*)(addr))
+#endif
+
+/**
+ * CRC of a single byte value @c V (starting with 0 CRC).
+ */
+template<class Ret, Ret RevPoly, unsigned long V, int Bits = 8>
+struct CrcTabByte
+{
+    static const Ret value = CrcTabByte<Ret, RevPoly,
+        ((V & 1) ? ((V >> 1) ^ RevPoly) : (V >> 1)), Bits-1>::value;
+};
+
+template<class Ret, Ret RevPoly, unsigned long V>
+struct CrcTabByte<Ret, RevPoly, V, 0>
+{
+    static const Ret value = (Ret)V;
+};
+
+/**
+ * CRC of a single byte value @c V followed by @c K zero bytes (starting
+ * with 0 CRC). Used for slicing-by-N tables generation.
+ */
+template<class Ret, Ret RevPoly, unsigned long V, int K>
+struct CrcTabSlice
+{
+    static const Ret prev = CrcTabSlice<Ret, RevPoly, V, K-1>::value;
+    static const Ret value = (Ret)((prev >> 8) ^
+        CrcTabByte<Ret, RevPoly, (unsigned long)(prev & 0xff)>::value);
+};
+
+template<class Ret, Ret RevPoly, unsigned long V>
+struct CrcTabSlice<Ret, RevPoly, V, 0>
+{
+    static const Ret value = CrcTabByte<Ret, RevPoly, V>::value;
+};
+
+#define __CRCTAB_4(e, i) e(i), e((i)+1), e((i)+2), e((i)+3)
+#define __CRCTAB_16(e, i) \
+    __CRCTAB_4(e, i), __CRCTAB_4(e, (i)+4), \
+    __CRCTAB_4(e, (i)+8), __CRCTAB_4(e, (i)+12)
+#define __CRCTAB_64(e, i) \
+    __CRCTAB_16(e, i), __CRCTAB_16(e, (i)+16), \
+    __CRCTAB_16(e, (i)+32), __CRCTAB_16(e, (i)+48)
+#define __CRCTAB_256(e) \
+    __CRCTAB_64(e, 0), __CRCTAB_64(e, 64), \
+    __CRCTAB_64(e, 128), __CRCTAB_64(e, 192)
+
+/**
+ * 256 elements CRC table: CRC of a byte value followed by @c K zero bytes.
+ * @c K == 0 for a basic byte-wise CRC table, @c K > 0 for subsequent
+ * slicing-by-N tables.
+ */
+template<class Ret, Ret RevPoly, int K = 0>
+struct CrcTab256 {
+    static const Ret tab[256];
+};
+
+#define __CRCTAB_SLICE(i) CrcTabSlice<Ret, RevPoly, (i), K>::value
+
+template<class Ret, Ret RevPoly, int K>
+const Ret CRCTAB_STORAGE CrcTab256<Ret, RevPoly, K>::tab[256] = {
+    __CRCTAB_256(__CRCTAB_SLICE)
+};
+
+#undef __CRCTAB_SLICE
+
+/**
+ * 2x16 elements CRC tables: CRC of a byte value with 0 high (@c 16L table)
+ * and low (@c 16H table) nibble.
+ */
+template<class Ret, Ret RevPoly>
+struct CrcTab16LH {
+    static const Ret tabL[16];
+    static const Ret tabH[16];
+};
+
+#define __CRCTAB_L(i) CrcTabByte<Ret, RevPoly, (i)>::value
+#define __CRCTAB_H(i) CrcTabByte<Ret, RevPoly, ((i) << 4)>::value
+
+template<class Ret, Ret RevPoly>
+const Ret CRCTAB_STORAGE CrcTab16LH<Ret, RevPoly>::tabL[16] = {
+    __CRCTAB_16(__CRCTAB_L, 0)
+};
+
+template<class Ret, Ret RevPoly>
+const Ret CRCTAB_STORAGE CrcTab16LH<Ret, RevPoly>::tabH[16] = {
+    __CRCTAB_16(__CRCTAB_H, 0)
+};
+
+#undef __CRCTAB_H
+#undef __CRCTAB_L
+#undef __CRCTAB_256
+#undef __CRCTAB_64
+#undef __CRCTAB_16
+#undef __CRCTAB_4
+
+/**
+ * Read CRC table element.
+ */
+template<class Ret>
+inline Ret crcTabRead(const Ret *addr);
+
+template<>
+inline uint8_t crcTabRead<uint8_t>(const uint8_t *addr) {
+    return tabRead_u8(addr);
+}
+
+template<>
+inline uint16_t crcTabRead<uint16_t>(const uint16_t *addr) {
+    return tabRead_u16(addr);
+}
+
+template<>
+inline uint32_t crcTabRead<uint32_t>(const uint32_t *addr) {
+    return tabRead_u32(addr);
+}
+
+/**
+ * Generic table-driven CRC calculation with 256 elements table (see
+ * @ref OneWireNg::crc() for the template parameters description).
+ */
+template<class Ret, Ret RevPoly>
+inline Ret crcTab256(const void *in, size_t len, Ret crc_in = 0)
+{
+    Ret crc = crc_in;
+    const uint8_t *in_bts = (const uint8_t*)in;
+
+    while (len--) {
+        crc = (Ret)((crc >> 8) ^ crcTabRead<Ret>(
+            &CrcTab256<Ret, RevPoly>::tab[(crc ^ *in_bts++) & 0xff]));
+    }
+    return crc;
+}
+
+#endif /* __OWNG_CRC_TAB__ */
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include "OneWireNg_DS2482.h"
+
+/*
+ * DS2482-800 channel select codes and their read-back values.
+ */
+static const uint8_t CHANNEL_CODES[] = {
+    0xf0, 0xe1, 0xd2, 0xc3, 0xb4, 0xa5, 0x96, 0x87
+};
+static const uint8_t CHANNEL_RDBACK[] = {
+    0xb8, 0xb1, 0xaa, 0xa3, 0x9c, 0x95, 0x8e, 0x87
+};
+
+OneWireNg::ErrorCode OneWireNg_DS2482::cmd(uint8_t code, int param)
+{
+    uint8_t buf[2] = {code, (uint8_t)param};
+    return _i2c.write(_addr, buf, (param >= 0 ? 2 : 1));
+}
+
+OneWireNg::ErrorCode OneWireNg_DS2482::writeConfig(uint8_t cfg)
+{
+    uint8_t rdback;
+
+    /* upper nibble of the written byte is one's complement of the lower */
+    ErrorCode ec = cmd(CMD_WRITE_CONFIG, cfg | (~cfg << 4 & 0xf0));
+    if (ec == EC_SUCCESS)
+        ec = readReg(&rdback);
+
+    if (ec == EC_SUCCESS) {
+        if (rdback != cfg)
+            return EC_BUS_ERROR;
+        _dcfg = cfg;
+    }
+    return ec;
+}
+
+OneWireNg::ErrorCode OneWireNg_DS2482::prepare1w(bool spu)
+{
+    uint8_t cfg = _cfg;
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+    if (_overdrive)
+        cfg |= CONFIG_1WS;
+#endif
+    /*
+     * Strong pull-up is disabled here, if still enabled. The SPU bit is
+     * consumed by the DS2482 on its activation, therefore it's always
+     * rewritten when armed.
+     */
+    if (spu)
+        cfg |= CONFIG_SPU;
+    return (cfg != _dcfg || spu ? writeConfig(cfg) : EC_SUCCESS);
+}
+
+OneWireNg::ErrorCode OneWireNg_DS2482::cmd1w(
+    uint8_t code, int param, uint8_t *status)
+{
+    ErrorCode ec = cmd(code, param);
+    if (ec != EC_SUCCESS)
+        return ec;
+
+    /* read pointer is set to the status register by the command */
+    for (int i=0; i < BUSY_POLLS; i++) {
+        if ((ec = readReg(status)) != EC_SUCCESS)
+            return ec;
+        if (!(*status & STATUS_1WB))
+            return EC_SUCCESS;
+    }
+    return EC_BUS_ERROR;
+}
+
+OneWireNg::ErrorCode OneWireNg_DS2482::begin()
+{
+    uint8_t status;
+
+    ErrorCode ec = cmd(CMD_DEVICE_RESET);
+    if (ec == EC_SUCCESS)
+        ec = readReg(&status);
+
+    if (ec == EC_SUCCESS) {
+        if (!(status & STATUS_RST))
+            return EC_BUS_ERROR;
+
+        /* the device reset clears the configuration */
+        _dcfg = 0;
+        ec = prepare1w();
+    }
+    return ec;
+}
+
+OneWireNg::ErrorCode OneWireNg_DS2482::selectChannel(int ch)
+{
+    uint8_t rdback;
+
+    if (ch < 0 || ch >= CHANNELS_800)
+        return EC_UNSUPPORED;
+
+    if (cmd(CMD_CHANNEL_SELECT, CHANNEL_CODES[ch]) != EC_SUCCESS)
+        return EC_UNSUPPORED;
+
+    ErrorCode ec = readReg(&rdback);
+    if (ec == EC_SUCCESS && rdback != CHANNEL_RDBACK[ch])
+        ec = EC_UNSUPPORED;
+    return ec;
+}
+
+OneWireNg::ErrorCode OneWireNg_DS2482::reset()
+{
+    uint8_t status;
+
+    ErrorCode ec = prepare1w();
+    if (ec == EC_SUCCESS)
+        ec = cmd1w(CMD_1W_RESET, -1, &status);
+
+    if (ec == EC_SUCCESS) {
+        if (status & STATUS_SD)
+            return EC_BUS_ERROR;
+        ec = (status & STATUS_PPD ? EC_SUCCESS : EC_NO_DEVS);
+    }
+    return ec;
+}
+
+int OneWireNg_DS2482::touchBit(int bit)
+{
+    uint8_t status;
+
+    if (prepare1w() != EC_SUCCESS ||
+        cmd1w(CMD_1W_SINGLE_BIT, (bit ? 0x80 : 0), &status) != EC_SUCCESS)
+    {
+        /* released bus is read on error */
+        return 1;
+    }
+    return ((status & STATUS_SBR) != 0);
+}
+
+void OneWireNg_DS2482::writeByte(uint8_t byte)
+{
+    uint8_t status;
+
+    if (prepare1w() == EC_SUCCESS)
+        cmd1w(CMD_1W_WRITE_BYTE, byte, &status);
+}
+
+uint8_t OneWireNg_DS2482::readByte()
+{
+    uint8_t status, data;
+
+    if (prepare1w() != EC_SUCCESS ||
+        cmd1w(CMD_1W_READ_BYTE, -1, &status) != EC_SUCCESS ||
+        cmd(CMD_SET_READ_PTR, REG_DATA) != EC_SUCCESS ||
+        readReg(&data) != EC_SUCCESS)
+    {
+        /* released bus is read on error */
+        return 0xff;
+    }
+    return data;
+}
+
+int OneWireNg_DS2482::touchTriplet(int dir)
+{
+    uint8_t status;
+
+    if (prepare1w() != EC_SUCCESS ||
+        cmd1w(CMD_1W_TRIPLET, (dir ? 0x80 : 0), &status) != EC_SUCCESS)
+    {
+        /* no devices responding on error */
+        return 3;
+    }
+    return (((status & STATUS_SBR) ? 1 : 0) |
+        ((status & STATUS_TSB) ? 2 : 0) |
+        ((status & STATUS_DIR) ? 4 : 0));
+}
+
+OneWireNg::ErrorCode OneWireNg_DS2482::powerBus(bool on)
+{
+    uint8_t status;
+
+    if (!on) {
+        return (_dcfg & CONFIG_SPU ?
+            writeConfig((uint8_t)(_dcfg & ~CONFIG_SPU)) : EC_SUCCESS);
+    }
+
+    ErrorCode ec = prepare1w(true);
+
+    /* the strong pull-up is activated after the slot */
+    if (ec == EC_SUCCESS)
+        ec = cmd1w(CMD_1W_SINGLE_BIT, 0x80, &status);
+    return ec;
+}
+
+OneWireNg::ErrorCode OneWireNg_DS2482::writeBytePwr(uint8_t byte)
+{
+    uint8_t status;
+
+    ErrorCode ec = prepare1w(true);
+
+    /* the strong pull-up is activated after the last slot of the byte */
+    if (ec == EC_SUCCESS)
+        ec = cmd1w(CMD_1W_WRITE_BYTE, byte, &status);
+    return ec;
+}
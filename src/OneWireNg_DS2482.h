@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __OWNG_DS2482__
+#define __OWNG_DS2482__
+
+#include "OneWireNg.h"
+
+/**
+ * DS2482 (I2C to 1-wire bridge) implementation of 1-wire bus activities:
+ * reset, touch, search triplet, parasite powering.
+ *
+ * The 1-wire slots are generated by the DS2482 hardware, therefore the bus
+ * timings don't depend on the host (no time critical sections, no GPIO
+ * bit-banging). The class supports DS2482-100 (single channel) and DS2482-800
+ * (8 channels under the same I2C address, see @ref selectChannel()).
+ *
+ * The DS2482 is accessed via the I2C transport interface (@ref I2c)
+ * provided by the caller. For Arduino platforms @ref OneWireNg_DS2482_Wire
+ * adapter (@c OneWireNg_DS2482_Wire.h) is provided for the Arduino Wire
+ * library.
+ *
+ * Byte and multi-byte touching routines and the search triplet are performed
+ * by the dedicated DS2482 commands. The routines are used by the library core
+ * (e.g. search, addressing) and the device drivers if the extended virtual
+ * interface is enabled (@ref CONFIG_EXT_VIRTUAL_INTF), otherwise the core
+ * falls back to the single bit commands.
+ *
+ * @note @ref begin() shall be called before the 1-wire bus usage (after the
+ *     I2C bus initialization).
+ */
+class OneWireNg_DS2482: public OneWireNg
+{
+public:
+    /**
+     * I2C transport interface.
+     */
+    class I2c
+    {
+    public:
+        virtual ~I2c() {}
+
+        /**
+         * Write @c len bytes of @c data to I2C device of 7-bit address
+         * @c addr (single I2C transaction).
+         *
+         * @return Error codes:
+         *     - @c EC_SUCCESS: Data written and acknowledged by the device.
+         *     - @c EC_BUS_ERROR: I2C bus error (e.g. device not responding).
+         */
+        virtual ErrorCode write(uint8_t addr, const uint8_t *data, size_t len) = 0;
+
+        /**
+         * Read @c len bytes into @c data from I2C device of 7-bit address
+         * @c addr (single I2C transaction).
+         *
+         * @return Same as for @ref write().
+         */
+        virtual ErrorCode read(uint8_t addr, uint8_t *data, size_t len) = 0;
+    };
+
+    /** DS2482 base I2C address (address pins grounded) */
+    const static uint8_t I2C_ADDR = 0x18;
+
+    /** Number of DS2482-800 channels */
+    const static int CHANNELS_800 = 8;
+
+    /**
+     * DS2482 commands.
+     */
+    const static uint8_t CMD_DEVICE_RESET   = 0xF0;
+    const static uint8_t CMD_SET_READ_PTR   = 0xE1;
+    const static uint8_t CMD_WRITE_CONFIG   = 0xD2;
+    const static uint8_t CMD_CHANNEL_SELECT = 0xC3;
+    const static uint8_t CMD_1W_RESET       = 0xB4;
+    const static uint8_t CMD_1W_SINGLE_BIT  = 0x87;
+    const static uint8_t CMD_1W_WRITE_BYTE  = 0xA5;
+    const static uint8_t CMD_1W_READ_BYTE   = 0x96;
+    const static uint8_t CMD_1W_TRIPLET     = 0x78;
+
+    /**
+     * DS2482 registers (read pointer codes).
+     */
+    const static uint8_t REG_STATUS  = 0xF0;
+    const static uint8_t REG_DATA    = 0xE1;
+    const static uint8_t REG_CHANNEL = 0xD2;
+    const static uint8_t REG_CONFIG  = 0xC3;
+
+    /**
+     * Status register bits.
+     */
+    const static uint8_t STATUS_1WB = 0x01;  /** 1-wire busy */
+    const static uint8_t STATUS_PPD = 0x02;  /** presence pulse detected */
+    const static uint8_t STATUS_SD  = 0x04;  /** short detected */
+    const static uint8_t STATUS_LL  = 0x08;  /** logic level */
+    const static uint8_t STATUS_RST = 0x10;  /** device reset */
+    const static uint8_t STATUS_SBR = 0x20;  /** single bit result */
+    const static uint8_t STATUS_TSB = 0x40;  /** triplet second bit */
+    const static uint8_t STATUS_DIR = 0x80;  /** branch direction taken */
+
+    /**
+     * Configuration register bits.
+     */
+    const static uint8_t CONFIG_APU = 0x01;  /** active pull-up */
+    const static uint8_t CONFIG_SPU = 0x04;  /** strong pull-up */
+    const static uint8_t CONFIG_1WS = 0x08;  /** 1-wire overdrive speed */
+
+    /**
+     * Max. number of the status register polls while waiting for a 1-wire
+     * command completion.
+     */
+    const static int BUSY_POLLS = 100;
+
+    /**
+     * OneWireNg_DS2482 constructor. No I2C activity is performed.
+     *
+     * @param i2c I2C transport.
+     * @param addr DS2482 I2C address.
+     * @param apu If @c true the DS2482 active pull-up is enabled
+     *     (recommended, except for a single slave on a short bus).
+     */
+    OneWireNg_DS2482(I2c& i2c, uint8_t addr = I2C_ADDR, bool apu = true):
+        _i2c(i2c), _addr(addr), _cfg(apu ? CONFIG_APU : 0), _dcfg(0) {}
+
+    /**
+     * Reset the DS2482 and write its configuration. On DS2482-800 channel 0
+     * is selected.
+     *
+     * @return Error codes:
+     *     - @c EC_SUCCESS: Operation finished with success.
+     *     - @c EC_BUS_ERROR: I2C communication error or the DS2482 not
+     *         responding as expected.
+     */
+    ErrorCode begin();
+
+    /**
+     * Select DS2482-800 channel @c ch (0..7) for subsequent 1-wire
+     * activities.
+     *
+     * @return Error codes:
+     *     - @c EC_SUCCESS: Channel selected.
+     *     - @c EC_UNSUPPORED: Invalid channel or the device is not
+     *         DS2482-800 (the command not acknowledged or the selection
+     *         not confirmed by the device).
+     *     - @c EC_BUS_ERROR: I2C communication error.
+     */
+    ErrorCode selectChannel(int ch);
+
+    /**
+     * @return Error codes as for @ref OneWireNg::reset() and additionally
+     *     @c EC_BUS_ERROR for short detected on the 1-wire bus or I2C
+     *     communication error.
+     */
+    ErrorCode reset();
+
+    int touchBit(int bit);
+
+    /**
+     * Byte touch. @c 0xff is touched by the DS2482 read byte command, other
+     * bytes bit by bit by the single bit command, since the write byte
+     * command doesn't provide the sampled bits. Use @ref writeByte() for
+     * writing, if the sampled bits are not needed.
+     */
+    uint8_t touchByte(uint8_t byte)
+    {
+        if (byte == 0xff)
+            return readByte();
+
+        uint8_t ret = 0;
+        for (int i=0; i < 8; i++)
+            ret |= (uint8_t)(touchBit((byte >> i) & 1) << i);
+        return ret;
+    }
+
+    void touchBytes(uint8_t *bytes, size_t len) {
+        for (size_t i=0; i < len; i++)
+            bytes[i] = touchByte(bytes[i]);
+    }
+
+    void writeByte(uint8_t byte);
+
+    void writeBytes(const uint8_t *bytes, size_t len) {
+        for (size_t i=0; i < len; i++)
+            writeByte(bytes[i]);
+    }
+
+    uint8_t readByte();
+
+    void readBytes(uint8_t *bytes, size_t len) {
+        for (size_t i=0; i < len; i++)
+            bytes[i] = readByte();
+    }
+
+    /**
+     * Search triplet performed by the DS2482 "1-Wire Triplet" command.
+     */
+    int touchTriplet(int dir);
+
+    /**
+     * Enable/disable the DS2482 strong pull-up on the 1-wire bus. The DS2482
+     * activates the strong pull-up after a 1-wire slot only, therefore
+     * enabling the powering issues a single read slot (ignored by the slave
+     * devices performing a function, e.g. temperature conversion).
+     *
+     * @note To power the bus after a function command use
+     *     @ref writeBytePwr(), which doesn't issue the additional slot.
+     */
+    ErrorCode powerBus(bool on);
+
+    /**
+     * Write a byte with the strong pull-up armed in the configuration
+     * register before the write, as prescribed by the DS2482 datasheet.
+     * The strong pull-up is activated by the DS2482 right after the last
+     * bit slot of the byte.
+     */
+    ErrorCode writeBytePwr(uint8_t byte);
+
+private:
+    /**
+     * Write DS2482 command @c code with optional parameter @c param
+     * (if >= 0).
+     */
+    ErrorCode cmd(uint8_t code, int param = -1);
+
+    /**
+     * Read DS2482 register pointed by the read pointer.
+     */
+    ErrorCode readReg(uint8_t *reg) {
+        return _i2c.read(_addr, reg, 1);
+    }
+
+    /**
+     * Write DS2482 configuration @c cfg.
+     */
+    ErrorCode writeConfig(uint8_t cfg);
+
+    /**
+     * Prepare the DS2482 for a 1-wire command: synchronize the configuration
+     * (speed, strong pull-up) with the library state.
+     *
+     * @param spu If @c true the strong pull-up is armed to be activated
+     *     after the 1-wire command.
+     */
+    ErrorCode prepare1w(bool spu = false);
+
+    /**
+     * Perform 1-wire command @c code with optional parameter @c param and
+     * wait for its completion. The final status register is written under
+     * @c status.
+     */
+    ErrorCode cmd1w(uint8_t code, int param, uint8_t *status);
+
+    I2c& _i2c;
+    uint8_t _addr;
+    uint8_t _cfg;   /** requested configuration (w/o strong pull-up) */
+    uint8_t _dcfg;  /** DS2482 configuration */
+};
+
+#endif /* __OWNG_DS2482__ */
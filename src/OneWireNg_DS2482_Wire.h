@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __OWNG_DS2482_WIRE__
+#define __OWNG_DS2482_WIRE__
+
+#include <Wire.h>
+#include "OneWireNg_DS2482.h"
+
+/**
+ * DS2482 I2C transport via the Arduino Wire library.
+ *
+ * @note The Wire object shall be initialized (@c begin()) by the caller.
+ */
+class OneWireNg_DS2482_Wire: public OneWireNg_DS2482::I2c
+{
+public:
+    OneWireNg_DS2482_Wire(TwoWire& wire = Wire): _wire(wire) {}
+
+    OneWireNg::ErrorCode write(uint8_t addr, const uint8_t *data, size_t len)
+    {
+        _wire.beginTransmission(addr);
+        _wire.write(data, len);
+        return (!_wire.endTransmission() ?
+            OneWireNg::EC_SUCCESS : OneWireNg::EC_BUS_ERROR);
+    }
+
+    OneWireNg::ErrorCode read(uint8_t addr, uint8_t *data, size_t len)
+    {
+        if ((size_t)_wire.requestFrom(addr, (uint8_t)len) != len)
+            return OneWireNg::EC_BUS_ERROR;
+
+        for (size_t i=0; i < len; i++)
+            data[i] = (uint8_t)_wire.read();
+        return OneWireNg::EC_SUCCESS;
+    }
+
+private:
+    TwoWire& _wire;
+};
+
+#endif /* __OWNG_DS2482_WIRE__ */
@@ -0,0 +1,653 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/* host only (tests, benchmarks) */
+#ifdef __TEST__
+
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+#include "OneWireNg_Simulated.h"
+#include "OneWireNg_Timings.h"
+
+/* ROM layer states */
+#define ST_IDLE     0   /* not selected; waiting for reset */
+#define ST_ROM      1   /* receiving ROM command */
+#define ST_READ_ROM 2   /* sending id */
+#define ST_MATCH    3   /* receiving id to match */
+#define ST_SEARCH   4   /* search triplets */
+#define ST_FUNC     5   /* selected; function layer */
+
+/* Dallas thermometers commands */
+#define DST_CONVERT_T           0x44
+#define DST_COPY_SCRATCHPAD     0x48
+#define DST_WRITE_SCRATCHPAD    0x4E
+#define DST_RECALL_E2           0xB8
+#define DST_READ_POW_SUPPLY     0xB4
+#define DST_READ_SCRATCHPAD     0xBE
+
+#define DS18S20     0x10
+#define DS28EA00    0x42
+
+/* EEPROM copy time (usec) */
+#define DST_COPY_TIME   10000
+
+/* DS2431 memory function commands */
+#define DS2431_WRITE_SCRATCHPAD 0x0F
+#define DS2431_COPY_SCRATCHPAD  0x55
+#define DS2431_READ_SCRATCHPAD  0xAA
+#define DS2431_READ_MEMORY      0xF0
+
+/* E/S flags */
+#define DS2431_ES_PF    0x20
+#define DS2431_ES_AA    0x80
+
+/* programming time (usec) */
+#define DS2431_PROG_TIME    10000
+
+OneWireNg_Simulated *OneWireNg_Simulated::_buses = NULL;
+OneWireNg_Simulated *OneWireNg_Simulated::_delayBus = NULL;
+
+/* floor division (b > 0) */
+static long floorDiv(long a, long b) {
+    return (a >= 0 ? a / b : -((-a + b - 1) / b));
+}
+
+OneWireNg_Simulated::Slave::Slave(
+    const Id& id, bool odSupport, bool rsmSupport):
+    _bus(NULL), _next(NULL), _state(ST_IDLE), _cmd(0), _n(0)
+{
+    memcpy(_id, id, sizeof(Id));
+    _flgs.od = 0;
+    _flgs.odSup = (odSupport != 0);
+    _flgs.rc = 0;
+    _flgs.rcSup = (rsmSupport != 0);
+}
+
+void OneWireNg_Simulated::Slave::makeId(Id& id, uint8_t code, unsigned long sn)
+{
+    id[0] = code;
+    for (size_t i=1; i < sizeof(Id)-1; i++) {
+        id[i] = (uint8_t)sn;
+        sn = (sizeof(sn) > 1 ? sn >> 8 : 0);
+    }
+    id[sizeof(Id)-1] = OneWireNg::crc8(&id[0], sizeof(Id)-1);
+}
+
+unsigned long OneWireNg_Simulated::Slave::getTime()
+{
+    return (_bus ? _bus->getTime() : 0);
+}
+
+int OneWireNg_Simulated::Slave::reset(bool od)
+{
+    if (!od) {
+        /* standard speed reset switches all slaves into the standard mode */
+        _flgs.od = 0;
+    } else
+    if (!_flgs.od) {
+        /* overdrive reset is not recognized by standard speed slaves */
+        return 1;
+    }
+
+    _state = ST_ROM;
+    _cmd = 0;
+    _n = 0;
+
+    /* presence pulse */
+    return 0;
+}
+
+int OneWireNg_Simulated::Slave::touch(int bit, bool od)
+{
+    int ret = 1;
+
+    /* slot of a speed not matching the slave is ignored */
+    if (od != (_flgs.od != 0))
+        return ret;
+
+    switch (_state)
+    {
+    case ST_ROM:
+        setBit(&_cmd, _n, bit);
+        if (++_n < 8)
+            break;
+
+        _n = 0;
+        _state = ST_IDLE;
+
+        switch (_cmd)
+        {
+        case CMD_READ_ROM:
+            _flgs.rc = 0;
+            _state = ST_READ_ROM;
+            break;
+
+        case CMD_MATCH_ROM:
+            _state = ST_MATCH;
+            break;
+
+        case CMD_SKIP_ROM:
+            _flgs.rc = 0;
+            _state = ST_FUNC;
+            break;
+
+        case CMD_RESUME:
+            if (_flgs.rcSup && _flgs.rc)
+                _state = ST_FUNC;
+            break;
+
+        case CMD_SEARCH_ROM_COND:
+            if (!isAlarmed()) {
+                _flgs.rc = 0;
+                break;
+            }
+            /* fall through */
+        case CMD_SEARCH_ROM:
+            _state = ST_SEARCH;
+            break;
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+        case CMD_SKIP_ROM_OVERDRIVE:
+            if (_flgs.odSup) {
+                _flgs.od = 1;
+                _flgs.rc = 0;
+                _state = ST_FUNC;
+            }
+            break;
+
+        case CMD_MATCH_ROM_OVERDRIVE:
+            if (_flgs.odSup) {
+                _flgs.od = 1;
+                _state = ST_MATCH;
+            }
+            break;
+#endif
+        default:
+            break;
+        }
+        break;
+
+    case ST_READ_ROM:
+        ret = getBit(_id, _n);
+        if (++_n >= 8*sizeof(Id)) {
+            _n = 0;
+            _state = ST_FUNC;
+        }
+        break;
+
+    case ST_MATCH:
+        if (getBit(_id, _n) != bit) {
+            _flgs.rc = 0;
+#ifdef CONFIG_OVERDRIVE_ENABLED
+            /* not matching slaves return to the standard speed */
+            if (_cmd == CMD_MATCH_ROM_OVERDRIVE)
+                _flgs.od = 0;
+#endif
+            _state = ST_IDLE;
+        } else
+        if (++_n >= 8*sizeof(Id)) {
+            _flgs.rc = 1;
+            _n = 0;
+            _state = ST_FUNC;
+        }
+        break;
+
+    case ST_SEARCH:
+      {
+        int idBit = getBit(_id, _n / 3);
+
+        switch (_n % 3)
+        {
+        case 0:
+            ret = idBit;
+            break;
+        case 1:
+            ret = !idBit;
+            break;
+        default:
+            if (idBit != bit) {
+                _flgs.rc = 0;
+                _state = ST_IDLE;
+            }
+            break;
+        }
+
+        if (_state == ST_SEARCH && ++_n >= 3*8*sizeof(Id)) {
+            _flgs.rc = 1;
+            _n = 0;
+            _state = ST_FUNC;
+        }
+        break;
+      }
+
+    case ST_FUNC:
+        ret = funcTouch(_n++, bit);
+        break;
+
+    default:
+        break;
+    }
+    return ret;
+}
+
+OneWireNg_Simulated::DSThermSlave::DSThermSlave(
+    const Id& id, bool parasitic):
+    /* DS28EA00 supports overdrive and resume commands */
+    Slave(id, id[0] == DS28EA00, id[0] == DS28EA00),
+    _fcmd(0), _rx(0), _parasitic(parasitic), _alarm(false),
+    _busy(false), _conv(false), _busyEnd(0), _temp(85000)
+{
+    /* factory defaults: Th=75, Tl=70, 12-bits resolution */
+    _eeprom[0] = 0x4b;
+    _eeprom[1] = 0x46;
+    _eeprom[2] = (id[0] != DS18S20 ? 0x7f : 0xff);
+
+    _scrpd[2] = _eeprom[0];
+    _scrpd[3] = _eeprom[1];
+    _scrpd[4] = _eeprom[2];
+    _scrpd[5] = 0xff;
+    _scrpd[6] = 0x0c;
+    _scrpd[7] = 0x10;
+
+    /* power-up temperature */
+    latchTemp();
+    _alarm = false;
+}
+
+unsigned long OneWireNg_Simulated::DSThermSlave::getConversionTime()
+{
+    if (_id[0] != DS18S20)
+        return (750000UL >> (3 - ((_scrpd[4] >> 5) & 3)));
+    else
+        return 750000UL;
+}
+
+void OneWireNg_Simulated::DSThermSlave::setScratchpadCrc() {
+    _scrpd[8] = OneWireNg::crc8(_scrpd, 8);
+}
+
+void OneWireNg_Simulated::DSThermSlave::latchTemp()
+{
+    long temp = _temp, tint, t16;
+
+    if (temp < -55000) temp = -55000;
+    if (temp > 125000) temp = 125000;
+
+    /* temperature in 1/16 C units */
+    t16 = floorDiv(temp * 16, 1000);
+
+    if (_id[0] != DS18S20) {
+        unsigned res = (_scrpd[4] >> 5) & 3;
+
+        /* undefined bits for lower resolutions are cleared */
+        t16 &= ~((1L << (3 - res)) - 1);
+
+        _scrpd[0] = (uint8_t)t16;
+        _scrpd[1] = (uint8_t)(t16 >> 8);
+        tint = floorDiv(t16, 16);
+    } else {
+        long t2 = floorDiv(t16, 8);
+        long cr;
+
+        _scrpd[0] = (uint8_t)t2;
+        _scrpd[1] = (uint8_t)(t2 >> 8);
+        tint = floorDiv(t2, 2);
+
+        /* count remain */
+        cr = 12 - (t16 - 16 * tint);
+        _scrpd[6] = (uint8_t)(cr < 0 ? 0 : cr);
+    }
+
+    _alarm = (tint >= (int8_t)_scrpd[2] || tint <= (int8_t)_scrpd[3]);
+    setScratchpadCrc();
+}
+
+void OneWireNg_Simulated::DSThermSlave::update()
+{
+    if (_busy && getTime() >= _busyEnd) {
+        _busy = false;
+        if (_conv)
+            latchTemp();
+    }
+}
+
+bool OneWireNg_Simulated::DSThermSlave::isAlarmed()
+{
+    update();
+    return _alarm;
+}
+
+int OneWireNg_Simulated::DSThermSlave::funcTouch(unsigned n, int bit)
+{
+    update();
+
+    if (n < 8) {
+        setBit(&_fcmd, n, bit);
+        if (n < 7)
+            return 1;
+
+        /* function command received */
+        switch (_fcmd)
+        {
+        case DST_CONVERT_T:
+            _busy = _conv = true;
+            _busyEnd = getTime() + getConversionTime();
+            break;
+
+        case DST_COPY_SCRATCHPAD:
+            memcpy(_eeprom, &_scrpd[2], sizeof(_eeprom));
+            _busy = true;
+            _conv = false;
+            _busyEnd = getTime() + DST_COPY_TIME;
+            break;
+
+        case DST_RECALL_E2:
+            memcpy(&_scrpd[2], _eeprom, sizeof(_eeprom));
+            setScratchpadCrc();
+            break;
+
+        default:
+            break;
+        }
+        return 1;
+    }
+
+    n -= 8;
+    switch (_fcmd)
+    {
+    case DST_CONVERT_T:
+    case DST_COPY_SCRATCHPAD:
+        /* parasitically powered sensors can't signal operation status */
+        return (_busy && !_parasitic ? 0 : 1);
+
+    case DST_READ_POW_SUPPLY:
+        return (_parasitic ? 0 : 1);
+
+    case DST_READ_SCRATCHPAD:
+        return (n < 8*sizeof(_scrpd) ? getBit(_scrpd, n) : 1);
+
+    case DST_WRITE_SCRATCHPAD:
+        if (n < 8 * (_id[0] != DS18S20 ? 3U : 2U))
+        {
+            setBit(&_rx, n & 7, bit);
+            if ((n & 7) == 7) {
+                unsigned i = 2 + (n >> 3);
+
+                if (i < 4) {
+                    _scrpd[i] = _rx;
+                } else {
+                    /* resolution bits are the only writable ones */
+                    _scrpd[4] = (uint8_t)((_scrpd[4] & 0x1f) | (_rx & 0x60));
+                }
+                setScratchpadCrc();
+            }
+        }
+        return 1;
+
+    default:
+        return 1;
+    }
+}
+
+OneWireNg_Simulated::DS2431Slave::DS2431Slave(const Id& id):
+    Slave(id, true, true), _es(0), _copy(false), _busy(false), _busyEnd(0)
+{
+    memset(_mem, 0xff, sizeof(_mem));
+    memset(_scrpd, 0xff, sizeof(_scrpd));
+    memset(_buf, 0, sizeof(_buf));
+    _ta[0] = _ta[1] = 0;
+}
+
+void OneWireNg_Simulated::DS2431Slave::update()
+{
+    if (_busy && getTime() >= _busyEnd) {
+        _busy = false;
+        memcpy(&_mem[_ta[0] & ~7], _scrpd, sizeof(_scrpd));
+        _es |= DS2431_ES_AA;
+    }
+}
+
+int OneWireNg_Simulated::DS2431Slave::txCrc16(
+    unsigned n, const uint8_t *data, size_t len)
+{
+    if (n >= 16)
+        return 1;
+
+    uint16_t crc = (uint16_t)~OneWireNg::crc<uint16_t, 0xa001>(data, len);
+    return ((crc >> n) & 1);
+}
+
+int OneWireNg_Simulated::DS2431Slave::funcTouch(unsigned n, int bit)
+{
+    update();
+
+    if (n < 8) {
+        setBit(_buf, n, bit);
+        if (n == 7)
+            _copy = false;
+        return 1;
+    }
+
+    n -= 8;
+    switch (_buf[0])
+    {
+    case DS2431_WRITE_SCRATCHPAD:
+      {
+        if (n < 16) {
+            /* target address */
+            setBit(&_buf[1], n, bit);
+            if (n == 15) {
+                _ta[0] = _buf[1];
+                _ta[1] = _buf[2];
+                _es = (uint8_t)(DS2431_ES_PF | (_ta[0] & 7));
+            }
+            return 1;
+        }
+        n -= 16;
+
+        unsigned off = _ta[0] & 7;
+        unsigned dlen = 8 - off;
+
+        if (n < 8*dlen) {
+            /* data */
+            setBit(&_buf[3], n, bit);
+            setBit(&_scrpd[off], n, bit);
+            if ((n & 7) == 7) {
+                unsigned e = off + (n >> 3);
+                _es = (uint8_t)((e < 7 ? DS2431_ES_PF : 0) | e);
+            }
+            return 1;
+        }
+        /* inverted CRC-16 of command, address and data */
+        return txCrc16(n - 8*dlen, _buf, 3 + dlen);
+      }
+
+    case DS2431_READ_SCRATCHPAD:
+      {
+        unsigned off = _ta[0] & 7;
+        unsigned dlen = (_es & 7) + 1 - off;
+
+        if (!n) {
+            _buf[1] = _ta[0];
+            _buf[2] = _ta[1];
+            _buf[3] = _es;
+            memcpy(&_buf[4], &_scrpd[off], dlen);
+        }
+        if (n < 8*(3 + dlen))
+            return getBit(&_buf[1], n);
+
+        /* inverted CRC-16 of command, address, E/S and data */
+        return txCrc16(n - 8*(3 + dlen), _buf, 4 + dlen);
+      }
+
+    case DS2431_COPY_SCRATCHPAD:
+        if (n < 24) {
+            /* authorization pattern */
+            setBit(&_buf[1], n, bit);
+            if (n == 23) {
+                _copy = (_buf[1] == _ta[0] && _buf[2] == _ta[1] &&
+                    _buf[3] == _es && !(_es & DS2431_ES_PF) &&
+                    !_ta[1] && _ta[0] < MEM_SIZE);
+                if (_copy) {
+                    _busy = true;
+                    _busyEnd = getTime() + DS2431_PROG_TIME;
+                }
+            }
+            return 1;
+        }
+        /* alternating 0/1 after the copy completion */
+        return (_copy && !_busy ? (int)((n - 24) & 1) : 1);
+
+    case DS2431_READ_MEMORY:
+      {
+        if (n < 16) {
+            setBit(&_buf[1], n, bit);
+            if (n == 15) {
+                _ta[0] = _buf[1];
+                _ta[1] = _buf[2];
+            }
+            return 1;
+        }
+        n -= 16;
+
+        unsigned addr = ((unsigned)_ta[1] << 8 | _ta[0]) + (n >> 3);
+        return (addr < MEM_SIZE ? getBit(&_mem[addr], n & 7) : 1);
+      }
+
+    default:
+        return 1;
+    }
+}
+
+OneWireNg_Simulated::OneWireNg_Simulated():
+    _slaves(NULL), _pwr(false), _time(0), _nextBus(_buses)
+{
+    resetStats();
+    _buses = this;
+}
+
+OneWireNg_Simulated::~OneWireNg_Simulated()
+{
+    detachAll();
+
+    for (OneWireNg_Simulated **b = &_buses; *b; b = &(*b)->_nextBus) {
+        if (*b == this) {
+            *b = _nextBus;
+            break;
+        }
+    }
+    if (_delayBus == this)
+        _delayBus = NULL;
+}
+
+OneWireNg::ErrorCode OneWireNg_Simulated::reset()
+{
+    bool od = false;
+    int presPulse = 1;
+
+    _pwr = false;
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+    od = _overdrive;
+#endif
+    for (Slave *s = _slaves; s; s = s->_next)
+        presPulse &= s->reset(od);
+
+    if (od) {
+        slot(&_stats.od.reset, OD_RESET_TIME);
+    } else {
+        slot(&_stats.std.reset, STD_RESET_TIME);
+    }
+    return (presPulse ? EC_NO_DEVS : EC_SUCCESS);
+}
+
+int OneWireNg_Simulated::touchBit(int bit)
+{
+    bool od = false;
+    int smpl = (bit != 0);
+
+    _pwr = false;
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+    od = _overdrive;
+#endif
+    /* wired-AND of all bus participants */
+    for (Slave *s = _slaves; s; s = s->_next)
+        smpl &= s->touch((bit != 0), od);
+
+    if (od) {
+        if (bit) slot(&_stats.od.write1, OD_WRITE1_TIME);
+        else slot(&_stats.od.write0, OD_WRITE0_TIME);
+    } else {
+        if (bit) slot(&_stats.std.write1, STD_WRITE1_TIME);
+        else slot(&_stats.std.write0, STD_WRITE0_TIME);
+    }
+    return smpl;
+}
+
+void OneWireNg_Simulated::attach(Slave& slave)
+{
+    Slave **s = &_slaves;
+    while (*s) {
+        /* already attached */
+        if (*s == &slave)
+            return;
+        s = &(*s)->_next;
+    }
+    slave._bus = this;
+    slave._next = NULL;
+    slave._state = ST_IDLE;
+    *s = &slave;
+}
+
+void OneWireNg_Simulated::detach(Slave& slave)
+{
+    for (Slave **s = &_slaves; *s; s = &(*s)->_next) {
+        if (*s == &slave) {
+            *s = slave._next;
+            slave._bus = NULL;
+            slave._next = NULL;
+            break;
+        }
+    }
+}
+
+void OneWireNg_Simulated::detachAll()
+{
+    while (_slaves)
+        detach(*_slaves);
+}
+
+void OneWireNg_Simulated::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void hostDelayUs(unsigned long us)
+{
+    OneWireNg_Simulated *bus = OneWireNg_Simulated::_delayBus;
+
+    if (!bus && OneWireNg_Simulated::_buses) {
+        /* implicit delay target must be unambiguous */
+        assert(!OneWireNg_Simulated::_buses->_nextBus);
+        bus = OneWireNg_Simulated::_buses;
+    }
+
+    if (bus) {
+        bus->advanceTime(us);
+    } else {
+        usleep(us);
+    }
+}
+
+#endif /* __TEST__ */
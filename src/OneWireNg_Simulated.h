@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __OWNG_SIMULATED__
+#define __OWNG_SIMULATED__
+
+#include "OneWireNg.h"
+
+/**
+ * Simulated 1-wire bus.
+ *
+ * The class models a whole 1-wire bus with virtual slave devices connected
+ * to it. The bus is simulated at the slot level (reset, write-0, write-1
+ * alias read) with the wired-AND logic applied to the bus line. Each slot
+ * advances the bus virtual clock by its duration, as bit-banged by @ref
+ * OneWireNg_BitBang in the standard or overdrive mode, therefore the class
+ * enables to estimate the bus time occupied by 1-wire activities without
+ * a real hardware.
+ *
+ * Slave devices are modeled by classes derived from @ref Slave, which
+ * implements the ROM layer of the 1-wire protocol (read, match, skip, search,
+ * resume, overdrive). Device specific functions are provided by derivative
+ * classes; currently Dallas thermometers (@ref DSThermSlave) and DS2431
+ * EEPROM (@ref DS2431Slave) are modeled.
+ *
+ * @note The class is intended to be used on the host (tests, benchmarks),
+ *     therefore its implementation is compiled for host builds (@c __TEST__)
+ *     only.
+ */
+class OneWireNg_Simulated: public OneWireNg
+{
+public:
+    /**
+     * Simulated slave device.
+     */
+    class Slave
+    {
+    public:
+        /**
+         * @param id Slave id.
+         * @param odSupport If @c true the slave supports overdrive mode.
+         * @param rsmSupport If @c true the slave supports resume command.
+         */
+        Slave(const Id& id, bool odSupport = false, bool rsmSupport = false);
+
+        virtual ~Slave() {}
+
+        /**
+         * Get slave id.
+         */
+        const Id& getId() {
+            return _id;
+        }
+
+        /**
+         * Create slave @c id for given family @c code and serial number
+         * @c sn. CRC-8 part of the id is computed accordingly.
+         */
+        static void makeId(Id& id, uint8_t code, unsigned long sn);
+
+    protected:
+        /**
+         * Return @c true if the slave is in an alarm state (the slave is
+         * responding to conditional search).
+         */
+        virtual bool isAlarmed() {
+            return false;
+        }
+
+        /**
+         * Function layer bit touch. Called for each slot on the bus after
+         * the slave has been selected by a ROM command.
+         *
+         * @param n Number of the slot since the slave has been selected
+         *     (the first bit of function command byte is 0).
+         * @param bit Value written by the master.
+         *
+         * @return Value the slave writes on the bus (1: bus released).
+         */
+        virtual int funcTouch(unsigned n, int bit) {
+            UNUSED(n);
+            UNUSED(bit);
+            return 1;
+        }
+
+        /**
+         * Current time of the bus virtual clock (usec).
+         */
+        unsigned long getTime();
+
+        static int getBit(const uint8_t *buf, unsigned n) {
+            return ((buf[n >> 3] >> (n & 7)) & 1);
+        }
+
+        static void setBit(uint8_t *buf, unsigned n, int bit)
+        {
+            if (bit) buf[n >> 3] |= (uint8_t)(1 << (n & 7));
+            else buf[n >> 3] &= (uint8_t)~(1 << (n & 7));
+        }
+
+        Id _id;
+
+    private:
+        int reset(bool od);
+        int touch(int bit, bool od);
+
+        OneWireNg_Simulated *_bus;
+        Slave *_next;
+
+        uint8_t _state;     /** ROM layer state */
+        uint8_t _cmd;       /** ROM command */
+        unsigned _n;        /** slot number in the current state */
+
+        struct {
+            unsigned od:    1;  /** overdrive mode */
+            unsigned odSup: 1;  /** overdrive mode supported */
+            unsigned rc:    1;  /** resume flag */
+            unsigned rcSup: 1;  /** resume command supported */
+        } _flgs;
+
+    friend class OneWireNg_Simulated;
+    };
+
+    /**
+     * Dallas thermometer (DS18S20, DS1822, DS18B20, DS1825, DS28EA00) model.
+     */
+    class DSThermSlave: public Slave
+    {
+    public:
+        /**
+         * @param id Thermometer id (family code determines the sensor type).
+         * @param parasitic If @c true the sensor is parasitically powered.
+         */
+        DSThermSlave(const Id& id, bool parasitic = false);
+
+        /**
+         * Set temperature (in Celsius degrees multiplied by 1000) measured by
+         * subsequent conversions.
+         */
+        void setTemp(long temp) {
+            _temp = temp;
+        }
+
+        /**
+         * Get sensor scratchpad (9 bytes).
+         */
+        const uint8_t *getScratchpad() {
+            update();
+            return _scrpd;
+        }
+
+        /**
+         * Get sensor EEPROM (Th, Tl, configuration register).
+         */
+        const uint8_t *getEeprom() {
+            return _eeprom;
+        }
+
+        /**
+         * Get conversion time (usec) for the currently configured resolution.
+         */
+        unsigned long getConversionTime();
+
+    protected:
+        bool isAlarmed();
+        int funcTouch(unsigned n, int bit);
+
+    private:
+        void update();
+        void latchTemp();
+        void setScratchpadCrc();
+
+        uint8_t _scrpd[9];
+        uint8_t _eeprom[3];
+        uint8_t _fcmd;      /** function command */
+        uint8_t _rx;        /** received byte */
+        bool _parasitic;
+        bool _alarm;
+        bool _busy;         /** conversion/copy in progress */
+        bool _conv;         /** conversion (not copy) in progress */
+        unsigned long _busyEnd;
+        long _temp;
+    };
+
+    /**
+     * DS2431 (1024-bit 1-wire EEPROM) model.
+     */
+    class DS2431Slave: public Slave
+    {
+    public:
+        static const size_t MEM_SIZE = 0x90;
+
+        DS2431Slave(const Id& id);
+
+        /**
+         * Get device memory (@ref MEM_SIZE bytes).
+         */
+        uint8_t *getMemory() {
+            update();
+            return _mem;
+        }
+
+    protected:
+        int funcTouch(unsigned n, int bit);
+
+    private:
+        void update();
+        int txCrc16(unsigned n, const uint8_t *data, size_t len);
+
+        uint8_t _mem[MEM_SIZE];
+        uint8_t _scrpd[8];
+        uint8_t _buf[16];   /** function command + arguments */
+        uint8_t _ta[2];     /** target address */
+        uint8_t _es;        /** ending address with data status */
+        bool _copy;         /** copy scratchpad authorized */
+        bool _busy;         /** copy scratchpad in progress */
+        unsigned long _busyEnd;
+    };
+
+    /**
+     * Slots counters.
+     */
+    typedef struct {
+        unsigned long reset;    /** reset cycles */
+        unsigned long write0;   /** write-0 slots */
+        unsigned long write1;   /** write-1 slots (read slots included) */
+    } SlotCounters;
+
+    /**
+     * Bus activity statistics.
+     */
+    typedef struct {
+        SlotCounters std;       /** standard mode slots */
+        SlotCounters od;        /** overdrive mode slots */
+        unsigned long busTime;  /** time occupied by the slots (usec) */
+    } Stats;
+
+    OneWireNg_Simulated();
+    ~OneWireNg_Simulated();
+
+    ErrorCode reset();
+    int touchBit(int bit);
+
+    /**
+     * Simulated bus powering is always supported.
+     */
+    ErrorCode powerBus(bool on) {
+        _pwr = on;
+        return EC_SUCCESS;
+    }
+
+    /**
+     * Check if the bus is powered.
+     */
+    bool isPowered() {
+        return _pwr;
+    }
+
+    /**
+     * Connect @c slave to the bus.
+     */
+    void attach(Slave& slave);
+
+    /**
+     * Disconnect @c slave from the bus.
+     */
+    void detach(Slave& slave);
+
+    /**
+     * Disconnect all slaves from the bus.
+     */
+    void detachAll();
+
+    /**
+     * Current time of the bus virtual clock (usec).
+     */
+    unsigned long getTime() {
+        return _time;
+    }
+
+    /**
+     * Advance the bus virtual clock by @c us with no activity on the bus
+     * (e.g. master is waiting for a slave operation completion).
+     *
+     * @note For host builds (@c __TEST__) library's delay routines are
+     *     directed to this method of the bus set by @ref setDelayBus().
+     */
+    void advanceTime(unsigned long us) {
+        _time += us;
+    }
+
+    /**
+     * Direct library's delay routines (host builds) to the virtual clock of
+     * @c bus. If not set (or set to @c NULL) the delays are directed to the
+     * only existing simulated bus; if there are more such buses the delay
+     * target is ambiguous and the delay routines assert. If there is no
+     * simulated bus the delays are performed by sleeping.
+     *
+     * @note The setting is reset on destruction of @c bus.
+     */
+    static void setDelayBus(OneWireNg_Simulated *bus) {
+        _delayBus = bus;
+    }
+
+    /**
+     * Get bus activity statistics since the object creation or last call to
+     * @ref resetStats().
+     */
+    const Stats& getStats() {
+        return _stats;
+    }
+
+    /**
+     * Reset bus activity statistics.
+     */
+    void resetStats();
+
+private:
+    void slot(unsigned long *cnt, unsigned long time)
+    {
+        (*cnt)++;
+        _stats.busTime += time;
+        _time += time;
+    }
+
+    Slave *_slaves;
+    bool _pwr;
+    unsigned long _time;
+    Stats _stats;
+
+    OneWireNg_Simulated *_nextBus;  /** next bus on the list of buses */
+
+    static OneWireNg_Simulated *_buses;     /** existing simulated buses */
+    static OneWireNg_Simulated *_delayBus;  /** delay routines target */
+
+#ifdef __TEST__
+    friend void hostDelayUs(unsigned long us);
+#endif
+};
+
+#endif /* __OWNG_SIMULATED__ */
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/* host only (tests, benchmarks) */
+#ifdef __TEST__
+
+#include <string.h>
+#include "OneWireNg_SimulatedDS2482.h"
+
+typedef OneWireNg_DS2482 DS2482;
+
+/* DS2482-800 channel select codes and their read-back values */
+static const uint8_t CHANNEL_CODES[] = {
+    0xf0, 0xe1, 0xd2, 0xc3, 0xb4, 0xa5, 0x96, 0x87
+};
+static const uint8_t CHANNEL_RDBACK[] = {
+    0xb8, 0xb1, 0xaa, 0xa3, 0x9c, 0x95, 0x8e, 0x87
+};
+
+OneWireNg_SimulatedDS2482::OneWireNg_SimulatedDS2482(
+    OneWireNg_Simulated **buses, int n, uint8_t addr):
+    _buses(buses), _n(n), _addr(addr), _busyReads(1)
+{
+    deviceReset();
+    resetStats();
+}
+
+void OneWireNg_SimulatedDS2482::deviceReset()
+{
+    _ptr = DS2482::REG_STATUS;
+    _status = DS2482::STATUS_RST;
+    _data = 0;
+    _cfg = 0;
+    _ch = 0;
+    _busy = 0;
+    _spu = false;
+}
+
+void OneWireNg_SimulatedDS2482::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void OneWireNg_SimulatedDS2482::cmd1w(uint8_t cmd, uint8_t param)
+{
+    OneWireNg_Simulated& bus = *_buses[_ch];
+
+    /* strong pull-up ends on the next 1-wire command */
+    if (_spu) {
+        bus.powerBus(false);
+        _spu = false;
+    }
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+    bus.setOverdrive((_cfg & DS2482::CONFIG_1WS) != 0);
+#endif
+    _status &= (uint8_t)~(DS2482::STATUS_SBR |
+        DS2482::STATUS_TSB | DS2482::STATUS_DIR);
+
+    switch (cmd)
+    {
+    case DS2482::CMD_1W_RESET:
+      {
+        _stats.reset++;
+        OneWireNg::ErrorCode ec = bus.reset();
+
+        _status &= (uint8_t)~(DS2482::STATUS_PPD |
+            DS2482::STATUS_SD | DS2482::STATUS_RST);
+        if (ec == OneWireNg::EC_SUCCESS)
+            _status |= DS2482::STATUS_PPD;
+        break;
+      }
+
+    case DS2482::CMD_1W_SINGLE_BIT:
+        _stats.bit++;
+        if (bus.touchBit(param & 0x80))
+            _status |= DS2482::STATUS_SBR;
+        break;
+
+    case DS2482::CMD_1W_WRITE_BYTE:
+        _stats.wrByte++;
+        bus.writeByte(param);
+        break;
+
+    case DS2482::CMD_1W_READ_BYTE:
+        _stats.rdByte++;
+        _data = bus.readByte();
+        break;
+
+    case DS2482::CMD_1W_TRIPLET:
+      {
+        _stats.triplet++;
+        int v0 = bus.touchBit(1);
+        int v1 = bus.touchBit(1);
+        int dir = (v0 != v1 ? v0 : ((param & 0x80) != 0 || v0));
+
+        bus.touchBit(dir);
+        if (v0) _status |= DS2482::STATUS_SBR;
+        if (v1) _status |= DS2482::STATUS_TSB;
+        if (dir) _status |= DS2482::STATUS_DIR;
+        break;
+      }
+    }
+
+    /* strong pull-up is activated after the bit/byte commands */
+    if ((_cfg & DS2482::CONFIG_SPU) &&
+        (cmd == DS2482::CMD_1W_SINGLE_BIT || cmd == DS2482::CMD_1W_WRITE_BYTE))
+    {
+        bus.powerBus(true);
+        _spu = true;
+        _cfg &= (uint8_t)~DS2482::CONFIG_SPU;
+    }
+
+    _status |= DS2482::STATUS_LL;
+    _ptr = DS2482::REG_STATUS;
+    _busy = _busyReads;
+}
+
+OneWireNg::ErrorCode OneWireNg_SimulatedDS2482::write(
+    uint8_t addr, const uint8_t *data, size_t len)
+{
+    _stats.writes++;
+
+    /* not addressed or no command - NACK */
+    if (addr != _addr || !len)
+        return OneWireNg::EC_BUS_ERROR;
+
+    uint8_t cmd = data[0];
+    uint8_t param = (len > 1 ? data[1] : 0);
+
+    switch (cmd)
+    {
+    case DS2482::CMD_DEVICE_RESET:
+        deviceReset();
+        return OneWireNg::EC_SUCCESS;
+
+    case DS2482::CMD_SET_READ_PTR:
+        if (len < 2 || (param != DS2482::REG_STATUS &&
+            param != DS2482::REG_DATA && param != DS2482::REG_CONFIG &&
+            (param != DS2482::REG_CHANNEL || _n == 1)))
+        {
+            break;
+        }
+        _ptr = param;
+        return OneWireNg::EC_SUCCESS;
+
+    case DS2482::CMD_WRITE_CONFIG:
+        /* upper nibble must be one's complement of the lower one */
+        if (len < 2 || ((param ^ (param >> 4)) & 0x0f) != 0x0f)
+            break;
+
+        _cfg = (uint8_t)(param & 0x0f);
+        _status &= (uint8_t)~DS2482::STATUS_RST;
+        _ptr = DS2482::REG_CONFIG;
+
+        /* strong pull-up may be disabled by the configuration write */
+        if (_spu && !(_cfg & DS2482::CONFIG_SPU)) {
+            _buses[_ch]->powerBus(false);
+            _spu = false;
+        }
+        return OneWireNg::EC_SUCCESS;
+
+    case DS2482::CMD_CHANNEL_SELECT:
+        if (len < 2 || _n == 1)
+            break;
+
+        for (int i = 0; i < _n && i < DS2482::CHANNELS_800; i++) {
+            if (CHANNEL_CODES[i] == param) {
+                _ch = i;
+                _ptr = DS2482::REG_CHANNEL;
+                return OneWireNg::EC_SUCCESS;
+            }
+        }
+        break;
+
+    case DS2482::CMD_1W_SINGLE_BIT:
+    case DS2482::CMD_1W_WRITE_BYTE:
+    case DS2482::CMD_1W_TRIPLET:
+        if (len < 2)
+            break;
+        /* fall through */
+    case DS2482::CMD_1W_RESET:
+    case DS2482::CMD_1W_READ_BYTE:
+        cmd1w(cmd, param);
+        return OneWireNg::EC_SUCCESS;
+    }
+    return OneWireNg::EC_BUS_ERROR;
+}
+
+OneWireNg::ErrorCode OneWireNg_SimulatedDS2482::read(
+    uint8_t addr, uint8_t *data, size_t len)
+{
+    _stats.reads++;
+
+    if (addr != _addr)
+        return OneWireNg::EC_BUS_ERROR;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        switch (_ptr)
+        {
+        case DS2482::REG_STATUS:
+            data[i] = _status;
+            if (_busy > 0) {
+                data[i] |= DS2482::STATUS_1WB;
+                _busy--;
+            }
+            break;
+
+        case DS2482::REG_DATA:
+            data[i] = _data;
+            break;
+
+        case DS2482::REG_CONFIG:
+            data[i] = _cfg;
+            break;
+
+        case DS2482::REG_CHANNEL:
+            data[i] = CHANNEL_RDBACK[_ch];
+            break;
+        }
+    }
+    return OneWireNg::EC_SUCCESS;
+}
+
+#endif /* __TEST__ */
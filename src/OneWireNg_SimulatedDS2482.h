@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __OWNG_SIMULATED_DS2482__
+#define __OWNG_SIMULATED_DS2482__
+
+#include "OneWireNg_DS2482.h"
+#include "OneWireNg_Simulated.h"
+
+/**
+ * Simulated DS2482 (I2C to 1-wire bridge).
+ *
+ * The class models DS2482 as seen on the I2C bus (@ref OneWireNg_DS2482::I2c
+ * transport) with its 1-wire channels connected to simulated 1-wire buses
+ * (@ref OneWireNg_Simulated). The DS2482 1-wire commands are performed on the
+ * currently selected channel's bus, therefore the bus statistics reflect the
+ * slots generated by the DS2482.
+ *
+ * @note The class is intended to be used on the host (tests, benchmarks),
+ *     therefore its implementation is compiled for host builds (@c __TEST__)
+ *     only.
+ */
+class OneWireNg_SimulatedDS2482: public OneWireNg_DS2482::I2c
+{
+public:
+    /**
+     * DS2482 commands statistics.
+     */
+    typedef struct {
+        unsigned long writes;   /** I2C write transactions */
+        unsigned long reads;    /** I2C read transactions */
+        unsigned long reset;    /** 1-wire reset commands */
+        unsigned long bit;      /** 1-wire single bit commands */
+        unsigned long wrByte;   /** 1-wire write byte commands */
+        unsigned long rdByte;   /** 1-wire read byte commands */
+        unsigned long triplet;  /** 1-wire triplet commands */
+    } Stats;
+
+    /**
+     * @param buses Table of @c n simulated 1-wire buses connected to the
+     *     DS2482 channels: 1 bus for DS2482-100, 8 buses for DS2482-800.
+     * @param n Number of buses.
+     * @param addr DS2482 I2C address.
+     */
+    OneWireNg_SimulatedDS2482(OneWireNg_Simulated **buses, int n = 1,
+        uint8_t addr = OneWireNg_DS2482::I2C_ADDR);
+
+    OneWireNg::ErrorCode write(uint8_t addr, const uint8_t *data, size_t len);
+    OneWireNg::ErrorCode read(uint8_t addr, uint8_t *data, size_t len);
+
+    /**
+     * Set number of the status register reads reporting the 1-wire busy
+     * state after each 1-wire command.
+     */
+    void setBusyReads(int n) {
+        _busyReads = n;
+    }
+
+    /**
+     * Get DS2482 configuration register.
+     */
+    uint8_t getConfig() {
+        return _cfg;
+    }
+
+    /**
+     * Get DS2482-800 selected channel.
+     */
+    int getChannel() {
+        return _ch;
+    }
+
+    /**
+     * Get DS2482 commands statistics since the object creation or last call
+     * to @ref resetStats().
+     */
+    const Stats& getStats() {
+        return _stats;
+    }
+
+    /**
+     * Reset DS2482 commands statistics.
+     */
+    void resetStats();
+
+private:
+    void deviceReset();
+
+    /**
+     * Perform 1-wire command @c cmd with parameter @c param on the selected
+     * channel.
+     */
+    void cmd1w(uint8_t cmd, uint8_t param);
+
+    OneWireNg_Simulated **_buses;
+    int _n;
+    uint8_t _addr;
+
+    uint8_t _ptr;       /** read pointer */
+    uint8_t _status;    /** status register */
+    uint8_t _data;      /** read data register */
+    uint8_t _cfg;       /** configuration register */
+    int _ch;            /** selected channel */
+    int _busyReads;
+    int _busy;          /** remaining busy status reads */
+    bool _spu;          /** strong pull-up active */
+    Stats _stats;
+};
+
+#endif /* __OWNG_SIMULATED_DS2482__ */
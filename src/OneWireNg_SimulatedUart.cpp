@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/* host only (tests, benchmarks) */
+#ifdef __TEST__
+
+#include <string.h>
+#include "OneWireNg_SimulatedUart.h"
+
+OneWireNg_SimulatedUart::OneWireNg_SimulatedUart(OneWireNg_Simulated& bus):
+    _bus(bus), _baud(0), _baudFault(false), _xferFault(0)
+{
+    resetStats();
+}
+
+void OneWireNg_SimulatedUart::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+OneWireNg::ErrorCode OneWireNg_SimulatedUart::setBaud(unsigned long baud)
+{
+    if (baud != OneWireNg_Uart::RESET_BAUD && baud != OneWireNg_Uart::SLOT_BAUD)
+        return OneWireNg::EC_UNSUPPORED;
+    if (_baudFault)
+        return OneWireNg::EC_BUS_ERROR;
+
+    _stats.bauds++;
+    _baud = baud;
+    return OneWireNg::EC_SUCCESS;
+}
+
+OneWireNg::ErrorCode OneWireNg_SimulatedUart::xfer(
+    const uint8_t *tx, uint8_t *rx, size_t len)
+{
+    if (!_baud || (_xferFault && !--_xferFault))
+        return OneWireNg::EC_BUS_ERROR;
+
+    _stats.bursts++;
+    _stats.chars += len;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        uint8_t c = tx[i];
+
+        if (_baud == OneWireNg_Uart::RESET_BAUD &&
+            c == OneWireNg_Uart::RESET_CHAR)
+        {
+            if (_bus.reset() == OneWireNg::EC_SUCCESS)
+                c &= 0x1f;
+        } else
+        if (c & 1) {
+            if (!_bus.touchBit(1))
+                c &= 0xf0;
+        } else {
+            _bus.touchBit(0);
+        }
+        rx[i] = c;
+    }
+    return OneWireNg::EC_SUCCESS;
+}
+
+#endif /* __TEST__ */
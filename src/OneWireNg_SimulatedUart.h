@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __OWNG_SIMULATED_UART__
+#define __OWNG_SIMULATED_UART__
+
+#include "OneWireNg_Uart.h"
+#include "OneWireNg_Simulated.h"
+
+/**
+ * Simulated UART looped back via 1-wire bus.
+ *
+ * The class models UART with TX and RX lines connected to a simulated 1-wire
+ * bus (@ref OneWireNg_Simulated). Each transmitted character is decoded into
+ * a 1-wire slot (as generated by the UART signal on the bus) and the
+ * character received back is produced according to the bus state:
+ * - @ref OneWireNg_Uart::RESET_CHAR at @ref OneWireNg_Uart::RESET_BAUD:
+ *   reset; the presence pulse pulls low the upper data bits.
+ * - Other characters: write-1 (read) slot if the 1st data bit is 1 (short
+ *   low pulse), write-0 slot otherwise. A slave writing 0 in the read slot
+ *   pulls low the lower data bits.
+ *
+ * @note The class is intended to be used on the host (tests, benchmarks),
+ *     therefore its implementation is compiled for host builds (@c __TEST__)
+ *     only.
+ */
+class OneWireNg_SimulatedUart: public OneWireNg_Uart::Uart
+{
+public:
+    /**
+     * UART transfers statistics.
+     */
+    typedef struct {
+        unsigned long bauds;    /** baud rate changes */
+        unsigned long bursts;   /** transfers (bursts of characters) */
+        unsigned long chars;    /** transmitted characters */
+    } Stats;
+
+    /**
+     * @param bus Simulated 1-wire bus connected to the UART.
+     */
+    OneWireNg_SimulatedUart(OneWireNg_Simulated& bus);
+
+    OneWireNg::ErrorCode setBaud(unsigned long baud);
+    OneWireNg::ErrorCode xfer(const uint8_t *tx, uint8_t *rx, size_t len);
+
+    /**
+     * Get current baud rate.
+     */
+    unsigned long getBaud() {
+        return _baud;
+    }
+
+    /**
+     * Get UART transfers statistics since the object creation or last call
+     * to @ref resetStats().
+     */
+    const Stats& getStats() {
+        return _stats;
+    }
+
+    /**
+     * Reset UART transfers statistics.
+     */
+    void resetStats();
+
+    /**
+     * Simulate UART failure: if @c fault is @c true, baud rate changes fail
+     * with @c EC_BUS_ERROR.
+     */
+    void setBaudFault(bool fault) {
+        _baudFault = fault;
+    }
+
+    /**
+     * Simulate UART failure: the @c nth next transfer (counting from 1)
+     * fails with @c EC_BUS_ERROR. 0 disables the failure.
+     */
+    void setXferFault(unsigned long nth) {
+        _xferFault = nth;
+    }
+
+private:
+    OneWireNg_Simulated& _bus;
+    unsigned long _baud;
+    bool _baudFault;
+    unsigned long _xferFault;   /** transfers left to the failing one */
+    Stats _stats;
+};
+
+#endif /* __OWNG_SIMULATED_UART__ */
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019-2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/*
+ * 1-wire slot timings (in usecs) shared by the library's bus drivers.
+ *
+ * NOTE: This is an internal header, intended to be included by the library
+ * translation units and bus driver templates (OneWireNg_BitBangT) only.
+ */
+#ifndef __OWNG_TIMINGS__
+#define __OWNG_TIMINGS__
+
+/* Standard mode timings
+ */
+/* min. 480 us */
+#define STD_RESET_LOW   480
+/* reset high; presence-detect sampling: 68-75 us */
+#define STD_RESET_SMPL  70
+/* reset trailing high */
+#define STD_RESET_END   410
+
+/* write-0 low: 60-120 us */
+#define STD_WRITE0_LOW  60
+/* write-0 trailing high: 5-15 us */
+#define STD_WRITE0_END  10
+
+/* write-1 low */
+#define STD_WRITE1_LOW  5
+/* write-1 high; sampling max 15 us (low + high) */
+#define STD_WRITE1_SMPL 8
+/* write-1 trailing high */
+#define STD_WRITE1_END  56
+
+/* Overdrive mode timings
+ */
+/* reset low: 53-80 us */
+#define OD_RESET_LOW    68
+/* reset high; presence-detect sampling: 8-9 us */
+#define OD_RESET_SMPL   8
+/* reset high; trailing part */
+#define OD_RESET_END    40
+
+/* write-0 low: 8-13 us */
+#define OD_WRITE0_LOW   8
+/* write-0 trailing high: 1-2 us */
+#define OD_WRITE0_END   1
+
+/* write-1 low */
+#define OD_WRITE1_LOW   0   /* <0: no delay, 0: delay(0)==NOP, >1: usec delay */
+/* write-1 high; sampling max 2 us (low + high) */
+#define OD_WRITE1_SMPL (-1) /* <0: no delay, 0: delay(0)==NOP, >1: usec delay */
+/* write-1 trailing high */
+#define OD_WRITE1_END   7
+
+/* Whole slots durations (negative, no-delay timings count as 0)
+ */
+#define __SLOT_DELAY(t) ((t) > 0 ? (t) : 0)
+
+#define STD_RESET_TIME  (STD_RESET_LOW + STD_RESET_SMPL + STD_RESET_END)
+#define STD_WRITE0_TIME (STD_WRITE0_LOW + STD_WRITE0_END)
+#define STD_WRITE1_TIME (STD_WRITE1_LOW + STD_WRITE1_SMPL + STD_WRITE1_END)
+
+#define OD_RESET_TIME   (OD_RESET_LOW + OD_RESET_SMPL + OD_RESET_END)
+#define OD_WRITE0_TIME  (OD_WRITE0_LOW + OD_WRITE0_END)
+#define OD_WRITE1_TIME  \
+    (__SLOT_DELAY(OD_WRITE1_LOW) + __SLOT_DELAY(OD_WRITE1_SMPL) + OD_WRITE1_END)
+
+#endif /* __OWNG_TIMINGS__ */
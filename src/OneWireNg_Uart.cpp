@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <string.h>
+#include "OneWireNg_Uart.h"
+
+/* UART characters of write-1 (read) and write-0 slots */
+#define SLOT1_CHAR 0xff
+#define SLOT0_CHAR 0x00
+
+OneWireNg::ErrorCode OneWireNg_Uart::setBaud(unsigned long baud)
+{
+    ErrorCode ec = EC_SUCCESS;
+
+    if (_baud != baud) {
+        ec = _uart.setBaud(baud);
+        _baud = (ec == EC_SUCCESS ? baud : 0);
+    }
+    return ec;
+}
+
+OneWireNg::ErrorCode OneWireNg_Uart::reset()
+{
+    uint8_t c = RESET_CHAR;
+
+    ErrorCode ec = setBaud(RESET_BAUD);
+    if (ec == EC_SUCCESS)
+        ec = _uart.xfer(&c, &c, 1);
+
+    if (ec == EC_SUCCESS) {
+        if (!c)
+            /* bus held low */
+            return EC_BUS_ERROR;
+        ec = (c != RESET_CHAR ? EC_SUCCESS : EC_NO_DEVS);
+    }
+    return ec;
+}
+
+int OneWireNg_Uart::touchBit(int bit)
+{
+    uint8_t c = (bit ? SLOT1_CHAR : SLOT0_CHAR);
+
+    if (setBaud(SLOT_BAUD) != EC_SUCCESS || _uart.xfer(&c, &c, 1) != EC_SUCCESS)
+        /* released bus is read on error */
+        return 1;
+
+    return (c == SLOT1_CHAR);
+}
+
+int OneWireNg_Uart::touchTriplet(int dir)
+{
+    uint8_t c[2] = {SLOT1_CHAR, SLOT1_CHAR};
+
+    if (setBaud(SLOT_BAUD) != EC_SUCCESS || _uart.xfer(c, c, 2) != EC_SUCCESS)
+        /* no devices responding on error */
+        return 3;
+
+    int v0 = (c[0] == SLOT1_CHAR);
+    int v1 = (c[1] == SLOT1_CHAR);
+
+    if (v1 && v0)
+        return 3;
+
+    if (v1 || v0)
+        dir = !v1;
+
+    c[0] = (dir ? SLOT1_CHAR : SLOT0_CHAR);
+    if (_uart.xfer(c, c, 1) != EC_SUCCESS)
+        /* slaves' search path is unknown on error */
+        return 3;
+
+    return (v0 | (v1 << 1) | (dir ? 4 : 0));
+}
+
+void OneWireNg_Uart::touchBytesEng(const uint8_t *in, uint8_t *out, size_t len)
+{
+    if (setBaud(SLOT_BAUD) != EC_SUCCESS) {
+        /* released bus is read on error */
+        if (out)
+            memset(out, 0xff, len);
+        return;
+    }
+
+    while (len > 0)
+    {
+        size_t n = (len < CONFIG_UART_BURST_BYTES ?
+            len : CONFIG_UART_BURST_BYTES);
+
+        /* each bit is transmitted as a single character (LSB first) */
+        for (size_t i = 0; i < n; i++) {
+            uint8_t byte = (in ? in[i] : 0xff);
+            for (int j = 0; j < 8; j++, byte >>= 1)
+                _buf[8*i + j] = ((byte & 1) ? SLOT1_CHAR : SLOT0_CHAR);
+        }
+
+        bool ok = (_uart.xfer(_buf, _buf, 8*n) == EC_SUCCESS);
+
+        if (out) {
+            for (size_t i = 0; i < n; i++) {
+                uint8_t ret = 0;
+                for (int j = 0; j < 8; j++) {
+                    /* released bus is read on error */
+                    if (!ok || _buf[8*i + j] == SLOT1_CHAR)
+                        ret |= (uint8_t)(1 << j);
+                }
+                out[i] = ret;
+            }
+            out += n;
+        }
+        if (in) in += n;
+        len -= n;
+    }
+}
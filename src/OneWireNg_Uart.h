@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __OWNG_UART__
+#define __OWNG_UART__
+
+#include "OneWireNg.h"
+
+#ifndef CONFIG_UART_BURST_BYTES
+# define CONFIG_UART_BURST_BYTES 8
+#endif
+
+/**
+ * UART implementation of 1-wire bus activities: reset, touch.
+ *
+ * The 1-wire slots are generated by the UART with its TX and RX lines
+ * connected to the 1-wire data wire (TX via open-drain output or a diode),
+ * therefore the slots timings don't depend on the CPU:
+ * - Reset: @c 0xf0 character transmitted at 9600 baud. The master's low
+ *   pulse is formed by the start bit and 4 low data bits; the received
+ *   character differs from the transmitted one if a presence pulse occurred.
+ * - Bit touch: single character transmitted at 115200 baud, @c 0xff for
+ *   write-1 (read) slot, @c 0x00 for write-0 slot. A slave writing 0 in the
+ *   read slot pulls low the character's data bits, therefore 1 is read only
+ *   if @c 0xff is received.
+ *
+ * Bytes touching routines transmit 8 characters per byte in bursts (up to
+ * @ref CONFIG_UART_BURST_BYTES bytes each), which the UART transport may
+ * perform by a DMA or FIFO transfer. The routines are used by the library
+ * core and the device drivers if the extended virtual interface is enabled
+ * (@ref CONFIG_EXT_VIRTUAL_INTF), otherwise the core falls back to single
+ * bit touches.
+ *
+ * The UART is accessed via the transport interface (@ref Uart) provided by
+ * the caller (@c OneWireNg_Uart_Serial for the Arduino @c HardwareSerial).
+ *
+ * @note Only the standard mode is supported. The bus powering is not
+ *     supported.
+ */
+class OneWireNg_Uart: public OneWireNg
+{
+public:
+    /**
+     * UART transport interface.
+     */
+    class Uart
+    {
+    public:
+        virtual ~Uart() {}
+
+        /**
+         * Set UART @c baud rate (8 data bits, no parity, 1 stop bit).
+         */
+        virtual ErrorCode setBaud(unsigned long baud) = 0;
+
+        /**
+         * Transmit @c len characters from @c tx and receive the same number
+         * of characters (echoed by the 1-wire bus) into @c rx. The
+         * characters shall be transmitted back-to-back (single DMA or FIFO
+         * burst). @c tx and @c rx may point to the same buffer.
+         *
+         * @return Error codes:
+         *     - @c EC_SUCCESS: Characters transmitted and received.
+         *     - @c EC_BUS_ERROR: UART error (e.g. receive timeout).
+         */
+        virtual ErrorCode xfer(const uint8_t *tx, uint8_t *rx, size_t len) = 0;
+    };
+
+    /** Reset baud rate */
+    const static unsigned long RESET_BAUD = 9600;
+
+    /** Slots baud rate */
+    const static unsigned long SLOT_BAUD = 115200;
+
+    /** Reset character */
+    const static uint8_t RESET_CHAR = 0xf0;
+
+    /**
+     * OneWireNg_Uart constructor.
+     *
+     * @param uart UART transport.
+     */
+    OneWireNg_Uart(Uart& uart): _uart(uart), _baud(0) {}
+
+    /**
+     * @return Error codes as for @ref OneWireNg::reset() and additionally
+     *     @c EC_BUS_ERROR for UART error or bus short (no character
+     *     received).
+     */
+    ErrorCode reset();
+
+    int touchBit(int bit);
+
+    uint8_t touchByte(uint8_t byte) {
+        uint8_t ret;
+        touchBytesEng(&byte, &ret, 1);
+        return ret;
+    }
+
+    void touchBytes(uint8_t *bytes, size_t len) {
+        touchBytesEng(bytes, bytes, len);
+    }
+
+    void writeByte(uint8_t byte) {
+        touchBytesEng(&byte, NULL, 1);
+    }
+
+    void writeBytes(const uint8_t *bytes, size_t len) {
+        touchBytesEng(bytes, NULL, len);
+    }
+
+    uint8_t readByte() {
+        uint8_t ret;
+        touchBytesEng(NULL, &ret, 1);
+        return ret;
+    }
+
+    void readBytes(uint8_t *bytes, size_t len) {
+        touchBytesEng(NULL, bytes, len);
+    }
+
+    /**
+     * Search triplet. Both read slots are transmitted in a single burst.
+     */
+    int touchTriplet(int dir);
+
+private:
+    /**
+     * Set UART baud rate @c baud (if not already set).
+     */
+    ErrorCode setBaud(unsigned long baud);
+
+    /**
+     * Bytes touching engine. Touch @c len bytes from @c in (@c 0xff bytes
+     * are touched if @c NULL) and write the result into @c out (the result
+     * is not stored if @c NULL). @c in and @c out may point to the same
+     * buffer.
+     */
+    void touchBytesEng(const uint8_t *in, uint8_t *out, size_t len);
+
+    Uart& _uart;
+    unsigned long _baud;    /** current baud rate */
+    uint8_t _buf[8 * CONFIG_UART_BURST_BYTES];
+};
+
+#endif /* __OWNG_UART__ */
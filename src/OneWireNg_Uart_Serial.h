@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __OWNG_UART_SERIAL__
+#define __OWNG_UART_SERIAL__
+
+#include "Arduino.h"
+#include "OneWireNg_Uart.h"
+
+/**
+ * UART transport via the Arduino @c HardwareSerial.
+ *
+ * The serial port TX line shall be connected to the 1-wire bus via
+ * open-drain buffer (or a diode), RX line directly. The serial port is
+ * (re)initialized by the transport on each baud rate change.
+ *
+ * @note The serial port RX buffer shall be able to hold a whole burst
+ *     (8 * @ref CONFIG_UART_BURST_BYTES characters), since the characters
+ *     are received after the burst is written.
+ */
+class OneWireNg_Uart_Serial: public OneWireNg_Uart::Uart
+{
+public:
+    /** Characters reception timeout (msec) */
+    const static unsigned long RX_TIMEOUT_MS = 20;
+
+    OneWireNg_Uart_Serial(HardwareSerial& serial): _serial(serial) {}
+
+    OneWireNg::ErrorCode setBaud(unsigned long baud)
+    {
+        _serial.flush();
+        _serial.end();
+        _serial.begin(baud);
+        _serial.setTimeout(RX_TIMEOUT_MS);
+        return OneWireNg::EC_SUCCESS;
+    }
+
+    OneWireNg::ErrorCode xfer(const uint8_t *tx, uint8_t *rx, size_t len)
+    {
+        /* drop stale characters */
+        while (_serial.available() > 0)
+            _serial.read();
+
+        /* TX characters are buffered, so rx may be the same buffer */
+        if (_serial.write(tx, len) != len)
+            return OneWireNg::EC_BUS_ERROR;
+
+        return (_serial.readBytes(rx, len) == len ?
+            OneWireNg::EC_SUCCESS : OneWireNg::EC_BUS_ERROR);
+    }
+
+private:
+    HardwareSerial& _serial;
+};
+
+#endif /* __OWNG_UART_SERIAL__ */
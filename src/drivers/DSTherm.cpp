@@ -25,30 +25,160 @@ DSTherm::FamilyCodeName
     { DS28EA00,"DS28EA00" }
 };
 
+OneWireNg::ErrorCode DSTherm::_readScratchpad(
+    const OneWireNg::Id& id, uint8_t *scrpd, size_t len)
+{
+    OneWireNg::ErrorCode ec = _ow.addressSingle(id);
+    if (ec == OneWireNg::EC_SUCCESS)
+    {
+        _ow.writeByte(CMD_READ_SCRATCHPAD);
+
+        if (len < Scratchpad::LENGTH) {
+            /* truncated read; reset terminates the slave's transmission */
+            _ow.readBytes(scrpd, len);
+            _ow.reset();
+        } else {
+            _ow.readBytes(scrpd, Scratchpad::LENGTH);
+
+            if (OneWireNg::crc8(scrpd, Scratchpad::LENGTH - 1) !=
+                scrpd[Scratchpad::LENGTH - 1])
+            {
+                ec = OneWireNg::EC_CRC_ERROR;
+            }
+        }
+    }
+    return ec;
+}
+
 OneWireNg::ErrorCode DSTherm::readScratchpad(
     const OneWireNg::Id& id, Scratchpad *scratchpad)
 {
-    OneWireNg::ErrorCode ec = _ow.addressSingle(id);
+    uint8_t scrpd[Scratchpad::LENGTH];
+
+    OneWireNg::ErrorCode ec = _readScratchpad(id, scrpd, sizeof(scrpd));
     if (ec == OneWireNg::EC_SUCCESS)
+        new (scratchpad) Scratchpad(_ow, id, scrpd);
+    return ec;
+}
+
+OneWireNg::ErrorCode DSTherm::_readTemp(const OneWireNg::Id& id,
+    long *temp, const Resolution *res, bool full)
+{
+    uint8_t scrpd[Scratchpad::LENGTH];
+    size_t len = Scratchpad::LENGTH;
+
+    if (!full) {
+        /* bytes needed for the temperature decoding */
+#ifdef CONFIG_DS18S20_EXT_RES
+        len = (id[0] != DS18S20 ? (res ? 2 : 5) : 8);
+#else
+        len = (id[0] != DS18S20 ? (res ? 2 : 5) : 2);
+#endif
+    }
+
+    OneWireNg::ErrorCode ec = _readScratchpad(id, scrpd, len);
+
+    /* the configuration register check (if read) detects the absent sensor */
+    if (ec == OneWireNg::EC_SUCCESS && len < Scratchpad::LENGTH &&
+        (len < 5 || id[0] == DS18S20))
     {
-        uint8_t cmd[1 + Scratchpad::LENGTH] = {
-            CMD_READ_SCRATCHPAD,
-            /* the read scratchpad will be placed here (9 bytes) */
-            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
-        };
+        size_t i = 0;
+        while (i < len && scrpd[i] == 0xff)
+            i++;
 
-        _ow.touchBytes(cmd, sizeof(cmd));
+        if (i == len) {
+            /*
+             * Released bus (absent sensor) is not distinguishable from all
+             * ones sent by the sensor; validate by the full (CRC) read.
+             */
+            len = Scratchpad::LENGTH;
+            ec = _readScratchpad(id, scrpd, len);
+        }
+    }
 
-        if (OneWireNg::crc8(&cmd[1], Scratchpad::LENGTH - 1) ==
-            cmd[Scratchpad::LENGTH])
-        {
-            new (scratchpad) Scratchpad(_ow, id, &cmd[1]);
+    if (ec == OneWireNg::EC_SUCCESS && id[0] != DS18S20) {
+        if (len < 5) {
+            /* configuration register not read; use the passed resolution */
+            scrpd[4] = (uint8_t)((((*res - RES_9_BIT) & 3) << 5) | 0x1f);
         } else
-            ec = OneWireNg::EC_CRC_ERROR;
+        if ((scrpd[4] & 0x90) != 0x10) {
+            /* configuration register sanity check (fixed bits) */
+            ec = OneWireNg::EC_BUS_ERROR;
+        }
     }
+
+    if (ec == OneWireNg::EC_SUCCESS)
+        *temp = decodeTemp(id, scrpd);
     return ec;
 }
 
+OneWireNg::ErrorCode DSTherm::_readTemp(
+    const OneWireNg::Id& id, long *temp, const Resolution *res)
+{
+    bool full = false;
+
+    if (_fullReadPeriod && ++_fullReadCnt >= _fullReadPeriod) {
+        _fullReadCnt = 0;
+        full = true;
+    }
+    return _readTemp(id, temp, res, full);
+}
+
+OneWireNg::ErrorCode DSTherm::sampleAll(const OneWireNg::Id *ids, size_t n,
+    long *temps, OneWireNg::ErrorCode *ecs, bool validate, int convTime,
+    bool parasitic)
+{
+    OneWireNg::ErrorCode ret = convertTempAll(convTime, parasitic);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        OneWireNg::ErrorCode ec = OneWireNg::EC_NO_DEVS;
+
+        /* no devices on the bus; remaining sensors are not read */
+        if (ret != OneWireNg::EC_NO_DEVS)
+            ec = _readTemp(ids[i], &temps[i], NULL, validate);
+
+        if (ec != OneWireNg::EC_SUCCESS && ret == OneWireNg::EC_SUCCESS)
+            ret = ec;
+        if (ecs)
+            ecs[i] = ec;
+    }
+    return ret;
+}
+
+OneWireNg::ErrorCode DSTherm::sampleAlarms(OneWireNg::Id *ids, size_t max,
+    size_t *found, long *temps, OneWireNg::ErrorCode *ecs, bool validate,
+    int convTime, bool parasitic)
+{
+    size_t n = 0;
+    OneWireNg::ErrorCode ret = convertTempAll(convTime, parasitic);
+
+    if (ret == OneWireNg::EC_SUCCESS) {
+        ret = _ow.searchAll(ids, max, &n, true);
+
+        /* no alarming sensors */
+        if (ret == OneWireNg::EC_NO_DEVS)
+            ret = OneWireNg::EC_SUCCESS;
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        /* id read with CRC error can't be addressed */
+        OneWireNg::ErrorCode ec = OneWireNg::checkCrcId(ids[i]);
+        if (ec == OneWireNg::EC_SUCCESS)
+            ec = _readTemp(ids[i], &temps[i], NULL, validate);
+
+        if (ec != OneWireNg::EC_SUCCESS && ret == OneWireNg::EC_SUCCESS)
+            ret = ec;
+        if (ecs)
+            ecs[i] = ec;
+    }
+
+    if (found)
+        *found = n;
+    return ret;
+}
+
 #if (CONFIG_MAX_SRCH_FILTERS > 0)
 OneWireNg::ErrorCode DSTherm::filterSupportedSlaves()
 {
@@ -89,29 +219,238 @@ const char *DSTherm::getFamilyName(const OneWireNg::Id& id)
     return NULL;
 }
 
-void DSTherm::_waitForCompletion(int ms, bool parasitic, int scanTimeoutMs)
+/* index of family with configurable resolution; -1 if not such family */
+static int resFamilyIdx(uint8_t code)
+{
+    switch (code) {
+    case DSTherm::DS1822:   return 0;
+    case DSTherm::DS18B20:  return 1;
+    case DSTherm::DS1825:   return 2;
+    case DSTherm::DS28EA00: return 3;
+    default:                return -1;
+    }
+}
+
+uint16_t *DSTherm::_convEstGet(const OneWireNg::Id *id, bool alloc)
+{
+    if (!id)
+        return &_convEstAll;
+
+    for (size_t i = 0; i < _convEstN; i++) {
+        if (_convEst[i].est &&
+            !memcmp(_convEst[i].id, *id, sizeof(OneWireNg::Id)))
+        {
+            return &_convEst[i].est;
+        }
+    }
+
+    if (!alloc || !_convEstN)
+        return NULL;
+
+    /* replace the entries in round-robin manner */
+    size_t i = _convEstNext;
+    _convEstNext = (i + 1) % _convEstN;
+
+    memcpy(_convEst[i].id, *id, sizeof(OneWireNg::Id));
+    _convEst[i].est = 0;
+    return &_convEst[i].est;
+}
+
+int DSTherm::_convNominal(const OneWireNg::Id *id)
+{
+    int res = 0;
+
+    if (id) {
+        int fi = resFamilyIdx((*id)[0]);
+        if (fi >= 0)
+            res = _nomRes[fi];
+    } else
+    if (_nomResAll) {
+        /* the slowest of the sensors */
+        for (int i = 0; i < RES_FAMILIES; i++) {
+            if (_nomRes[i] > res)
+                res = _nomRes[i];
+        }
+    }
+
+    /* resolution not known; nominal time of the slowest one */
+    return (res ? getConversionTime((Resolution)(res - 1)) : MAX_CONV_TIME);
+}
+
+void DSTherm::_convSetRes(const OneWireNg::Id *id, Resolution res)
 {
+    uint16_t *est;
+
+    if (id) {
+        int fi = resFamilyIdx((*id)[0]);
+        if (fi >= 0)
+            _nomRes[fi] = (uint8_t)(res + 1);
+
+        if ((est = _convEstGet(id, false)))
+            *est = 0;
+    } else {
+        for (int i = 0; i < RES_FAMILIES; i++)
+            _nomRes[i] = (uint8_t)(res + 1);
+        _nomResAll = true;
+
+        for (size_t i = 0; i < _convEstN; i++)
+            _convEst[i].est = 0;
+    }
+
+    /* the sensor(s) affect all sensors conversion time */
+    _convEstAll = 0;
+}
+
+void DSTherm::_waitForCompletion(
+    int ms, bool parasitic, int scanTimeoutMs, const OneWireNg::Id *id)
+{
+    /* for parasitic mode the bus is already powered by the command write */
     if (ms > 0) {
         /* wait specified amount of time */
-        if (parasitic) {
-            _ow.powerBus(true);
-            delayMs(ms);
+        delayMs(ms);
+        if (parasitic)
             _ow.powerBus(false);
-        } else
-            delayMs(ms);
     } else if (!ms) {
-        /* return immediately; power the bus for parasitic mode */
-        if (parasitic)
-            _ow.powerBus(true);
+        /* return immediately; the bus stays powered for parasitic mode */
     } else {
-        /* scan the bus for completion */
-        for (int i = 0; i < scanTimeoutMs; i++) {
+        /*
+         * Scan the bus for completion. The bus is not polled until the
+         * nominal conversion time for the sensor(s) resolution or 7/8 of
+         * the learned conversion time. Next, the bus is polled with
+         * exponential backoff of the polling period.
+         */
+        uint16_t *est = _convEstGet(id, false);
+        int first, waited, period = 1;
+
+        first = (est && *est ? *est - (*est >> 3) : _convNominal(id));
+        if (first > scanTimeoutMs)
+            first = scanTimeoutMs;
+        delayMs(first);
+        waited = first;
+
+        for (;;) {
             if (_ow.readBit())
                 break;
-            else
-                delayMs(1);
+
+            if (waited >= scanTimeoutMs) {
+                /* timeout; not learned */
+                return;
+            }
+
+            int d = (period < scanTimeoutMs - waited ?
+                period : scanTimeoutMs - waited);
+            delayMs(d);
+            waited += d;
+            if (period < SCAN_MAX_PERIOD)
+                period <<= 1;
         }
+
+        if (!est || !*est) {
+            /* the first completed conversion seeds the estimate */
+            if ((est = _convEstGet(id, true)))
+                *est = (uint16_t)(waited > 0 ? waited : 1);
+        } else
+        if (waited == first) {
+            /* completed before the first poll; the time is overestimated */
+            *est = (uint16_t)(first > 1 ? first >> 1 : 1);
+        } else {
+            /* moving average over recent conversions */
+            *est = (uint16_t)((3 * (unsigned long)*est + waited) >> 2);
+        }
+    }
+}
+
+OneWireNg::ErrorCode DSTherm::_startConvertTemp(const OneWireNg::Id *id,
+    unsigned long nowMs, int convTime, bool parasitic)
+{
+    OneWireNg::ErrorCode ec =
+        (id ? _ow.addressSingle(*id) : _ow.addressAll());
+
+    if (ec == OneWireNg::EC_SUCCESS) {
+        _writeCmd(CMD_CONVERT_T, parasitic);
+
+        _conv.pending = 1;
+        _conv.parasitic = parasitic;
+        _conv.scan = (convTime < 0 && !parasitic);
+        _conv.start = nowMs;
+        _conv.time = (convTime < 0 ? MAX_CONV_TIME : convTime);
+    }
+    return ec;
+}
+
+OneWireNg::ErrorCode DSTherm::pollConvert(
+    unsigned long nowMs, unsigned long *leftMs)
+{
+    if (_conv.pending)
+    {
+        /* wrap-around safe */
+        unsigned long elapsed = nowMs - _conv.start;
+
+        if (elapsed < _conv.time && !(_conv.scan && _ow.readBit())) {
+            if (leftMs)
+                *leftMs = _conv.time - elapsed;
+            return OneWireNg::EC_MORE;
+        }
+
+        if (_conv.parasitic)
+            _ow.powerBus(false);
+        _conv.pending = 0;
+    }
+
+    if (leftMs)
+        *leftMs = 0;
+    return OneWireNg::EC_SUCCESS;
+}
+
+OneWireNg::ErrorCode DSTherm::startConvertSched(
+    SchedSensor *sensors, size_t n, unsigned long nowMs)
+{
+    OneWireNg::ErrorCode ec = _ow.addressAll();
+
+    if (ec == OneWireNg::EC_SUCCESS) {
+        _ow.writeByte(CMD_CONVERT_T);
+
+        for (size_t i = 0; i < n; i++)
+            sensors[i].ec = OneWireNg::EC_MORE;
+
+        _sched.sensors = sensors;
+        _sched.n = n;
+        _sched.start = nowMs;
     }
+    return ec;
+}
+
+OneWireNg::ErrorCode DSTherm::pollSched(
+    unsigned long nowMs, unsigned long *leftMs)
+{
+    MAKE_SCRATCHPAD(scrpd);
+
+    /* wrap-around safe */
+    unsigned long elapsed = nowMs - _sched.start;
+    unsigned long left = 0;
+
+    for (size_t i = 0; i < _sched.n; i++)
+    {
+        SchedSensor& snsr = _sched.sensors[i];
+        if (snsr.ec != OneWireNg::EC_MORE)
+            continue;
+
+        unsigned long convTime =
+            (unsigned long)getConversionTime(snsr.id, snsr.res);
+
+        if (elapsed >= convTime) {
+            snsr.ec = readScratchpad(snsr.id, scrpd);
+            if (snsr.ec == OneWireNg::EC_SUCCESS)
+                snsr.temp = scrpd->getTemp();
+        } else
+        if (!left || convTime - elapsed < left) {
+            left = convTime - elapsed;
+        }
+    }
+
+    if (leftMs)
+        *leftMs = left;
+    return (left ? OneWireNg::EC_MORE : OneWireNg::EC_SUCCESS);
 }
 
 OneWireNg::ErrorCode DSTherm::_writeScratchpad(
@@ -120,6 +459,9 @@ OneWireNg::ErrorCode DSTherm::_writeScratchpad(
     OneWireNg::ErrorCode ec =
         (id ? _ow.addressSingle(*id) : _ow.addressAll());
 
+    /* resolution change affects the conversion time */
+    _convSetRes(id, (Resolution)(res & 3));
+
     if (ec == OneWireNg::EC_SUCCESS)
     {
         uint8_t cmd[4] = {
@@ -142,6 +484,68 @@ OneWireNg::ErrorCode DSTherm::_writeScratchpad(
     return ec;
 }
 
+/*
+ * Check if configuration @c cfg matches the settings @c th, @c tl, @c res
+ * (resolution is not configurable for DS18S20).
+ */
+static bool cfgMatch(
+    const DSTherm::SensorConfig& cfg, int8_t th, int8_t tl, uint8_t res)
+{
+    return (cfg.th == th && cfg.tl == tl &&
+        (cfg.id[0] == DSTherm::DS18S20 || cfg.res == res));
+}
+
+OneWireNg::ErrorCode DSTherm::_writeConfig(const SensorConfig *cfgs,
+    size_t n, bool all, bool copy, bool parasitic, int copyTime)
+{
+    OneWireNg::ErrorCode ec = OneWireNg::EC_SUCCESS;
+    size_t best = 0, bestCnt = 0;
+
+    /* the most common settings (broadcast if all sensors are configured) */
+    for (size_t i = 0; all && i < n; i++)
+    {
+        /* DS18S20 doesn't define resolution of its settings */
+        if (cfgs[i].id[0] == DS18S20)
+            continue;
+
+        size_t cnt = 0;
+        for (size_t j = 0; j < n; j++) {
+            if (cfgMatch(cfgs[j], cfgs[i].th, cfgs[i].tl, cfgs[i].res))
+                cnt++;
+        }
+        if (cnt > bestCnt) {
+            best = i;
+            bestCnt = cnt;
+        }
+    }
+
+    /* broadcast only if saves individual writes */
+    bool bcast = (bestCnt > 1);
+    if (bcast) {
+        ec = writeScratchpadAll(cfgs[best].th, cfgs[best].tl, cfgs[best].res);
+    }
+
+    for (size_t i = 0; ec == OneWireNg::EC_SUCCESS && i < n; i++)
+    {
+        if (bcast &&
+            cfgMatch(cfgs[i], cfgs[best].th, cfgs[best].tl, cfgs[best].res))
+        {
+            continue;
+        }
+        ec = writeScratchpad(cfgs[i].id, cfgs[i].th, cfgs[i].tl, cfgs[i].res);
+    }
+
+    if (ec == OneWireNg::EC_SUCCESS && copy) {
+        if (all) {
+            ec = copyScratchpadAll(parasitic, copyTime);
+        } else {
+            for (size_t i = 0; ec == OneWireNg::EC_SUCCESS && i < n; i++)
+                ec = copyScratchpad(cfgs[i].id, parasitic, copyTime);
+        }
+    }
+    return ec;
+}
+
 OneWireNg::ErrorCode DSTherm::Scratchpad::writeScratchpad()
 {
     OneWireNg::ErrorCode ec = _ow.addressSingle(_id);
@@ -162,23 +566,86 @@ inline long rsh(long v, int sh) {
     return (v < 0 ? -((-v) >> sh) : (v >> sh));
 }
 
-long DSTherm::Scratchpad::getTemp()
+long DSTherm::decodeTemp(const OneWireNg::Id& id, const uint8_t *scrpd)
 {
-    long temp = ((long)(int8_t)_scrpd[1] << 8) | _scrpd[0];
+    long temp = ((long)(int8_t)scrpd[1] << 8) | scrpd[0];
 
-    if (_id[0] != DS18S20) {
-        unsigned res = (_scrpd[4] >> 5) & 3;
+    if (id[0] != DS18S20) {
+        unsigned res = (scrpd[4] >> 5) & 3;
 
         temp = rsh(temp, 3 - res); /* truncate fractional undefined bits */
         temp = rsh(temp * 1000, res + 1);
     } else {
 #ifdef CONFIG_DS18S20_EXT_RES
-        if (_scrpd[7]) {
+        if (scrpd[7]) {
             temp = rsh(temp, 1) * 1000; /* truncate fractional part */
-            temp += (1000L * (int8_t)(_scrpd[7] - _scrpd[6]) / _scrpd[7]) - 250;
+            temp += (1000L * (int8_t)(scrpd[7] - scrpd[6]) / scrpd[7]) - 250;
         } else
 #endif
             temp = rsh(temp * 1000, 1);
     }
     return temp;
 }
+
+/* right shift of 16-bit value (sign aware) */
+inline int16_t rsh16(int16_t v, int sh) {
+    return (int16_t)(v < 0 ? -((-v) >> sh) : (v >> sh));
+}
+
+int16_t DSTherm::decodeTempQ8(const OneWireNg::Id& id, const uint8_t *scrpd)
+{
+    int16_t temp = (int16_t)(((uint16_t)scrpd[1] << 8) | scrpd[0]);
+
+    if (id[0] != DS18S20) {
+        /* Q12.4; truncate fractional undefined bits */
+        unsigned sh = 3 - ((scrpd[4] >> 5) & 3);
+        return (int16_t)((uint16_t)rsh16(temp, sh) << (sh + 4));
+    } else {
+#ifdef CONFIG_DS18S20_EXT_RES
+        uint8_t cpc = scrpd[7];
+        if (cpc) {
+            /* truncate fractional part */
+            temp = (int16_t)((uint16_t)rsh16(temp, 1) << 8);
+            uint16_t frac = (uint16_t)(cpc - scrpd[6]) << 8;
+            /* count per degree C is fixed to 16 for DS18S20 */
+            frac = (cpc == 16 ? frac >> 4 : frac / cpc);
+            return (int16_t)(temp + frac - 0x40);
+        }
+#endif
+        /* Q15.1 */
+        return (int16_t)((uint16_t)temp << 7);
+    }
+}
+
+/* hundredths of degree for 1/16 degree fractions (truncated) */
+static const uint8_t CENTI_16TH[16] = {
+    0, 6, 12, 18, 25, 31, 37, 43, 50, 56, 62, 68, 75, 81, 87, 93
+};
+
+int16_t DSTherm::decodeTempCenti(
+    const OneWireNg::Id& id, const uint8_t *scrpd)
+{
+    int16_t q8 = decodeTempQ8(id, scrpd);
+    uint16_t m = (uint16_t)(q8 < 0 ? -q8 : q8);
+
+    /* degrees multiplied by 100 as (x << 6) + (x << 5) + (x << 2) */
+    uint16_t dgr = m >> 8;
+    int16_t temp = (int16_t)((dgr << 6) + (dgr << 5) + (dgr << 2) +
+        CENTI_16TH[(m >> 4) & 0x0f]);
+
+    return (q8 < 0 ? -temp : temp);
+}
+
+void DSTherm::decodeTempQ8(const OneWireNg::Id *ids,
+    const uint8_t *scrpds, size_t n, int16_t *temps)
+{
+    for (size_t i = 0; i < n; i++, scrpds += Scratchpad::LENGTH)
+        temps[i] = decodeTempQ8(ids[i], scrpds);
+}
+
+void DSTherm::decodeTempCenti(const OneWireNg::Id *ids,
+    const uint8_t *scrpds, size_t n, int16_t *temps)
+{
+    for (size_t i = 0; i < n; i++, scrpds += Scratchpad::LENGTH)
+        temps[i] = decodeTempCenti(ids[i], scrpds);
+}
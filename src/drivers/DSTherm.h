@@ -48,7 +48,29 @@ public:
          * @return Temperature in Celsius degrees returned as fixed-point integer
          *     with multiplier 1000 , e.g. 20.125 C is returned as 20125.
          */
-        long getTemp();
+        long getTemp() {
+            return decodeTemp(_id, _scrpd);
+        }
+
+        /**
+         * Get temperature.
+         *
+         * @return Temperature in Celsius degrees returned as Q8.8 fixed-point
+         *     integer (1/256 C units), e.g. 20.125 C is returned as 0x1420.
+         */
+        int16_t getTempQ8() {
+            return decodeTempQ8(_id, _scrpd);
+        }
+
+        /**
+         * Get temperature.
+         *
+         * @return Temperature in Celsius degrees returned as fixed-point integer
+         *     with multiplier 100, e.g. 20.125 C is returned as 2012.
+         */
+        int16_t getTempCenti() {
+            return decodeTempCenti(_id, _scrpd);
+        }
 
         /**
          * Get Th.
@@ -214,12 +236,198 @@ public:
 #endif
     };
 
+    /**
+     * Non-owning view of a raw sensor scratchpad.
+     *
+     * As opposed to @ref Scratchpad, the view doesn't hold a copy of the
+     * sensor id and scratchpad bytes, but refers to caller provided storage
+     * (e.g. a table of raw scratchpads of all sensors on the bus read by
+     * @ref readScratchpad(const OneWireNg::Id&, uint8_t*)). The scratchpad
+     * is decoded in-place, with no copying involved:
+     *
+     * @code
+     * // ids: table of N sensors ids
+     * uint8_t scrpds[N][DSTherm::Scratchpad::LENGTH];
+     *
+     * for (size_t i = 0; i < N; i++) {
+     *     if (dsth.readScratchpad(ids[i], scrpds[i]) == OneWireNg::EC_SUCCESS)
+     *     {
+     *         DSTherm::ScratchpadView scrpd(ids[i], scrpds[i]);
+     *         long temp = scrpd.getTemp();
+     *         // ...
+     *     }
+     * }
+     * @endcode
+     *
+     * The view and the storage it refers to may be modified by the setters
+     * and sent to the sensor by @ref writeScratchpad(const ScratchpadView&).
+     * The referred storage must outlive the view.
+     */
+    class ScratchpadView
+    {
+    public:
+        /**
+         * Create view of raw scratchpad @c scrpd (@ref Scratchpad::LENGTH
+         * bytes) of a sensor with id @c id.
+         */
+        ScratchpadView(const OneWireNg::Id& id, uint8_t *scrpd):
+            _id(&id), _scrpd(scrpd) {}
+
+        /** @see Scratchpad::getTemp() */
+        long getTemp() const {
+            return decodeTemp(*_id, _scrpd);
+        }
+
+        /** @see Scratchpad::getTempQ8() */
+        int16_t getTempQ8() const {
+            return decodeTempQ8(*_id, _scrpd);
+        }
+
+        /** @see Scratchpad::getTempCenti() */
+        int16_t getTempCenti() const {
+            return decodeTempCenti(*_id, _scrpd);
+        }
+
+        /** @see Scratchpad::getTh() */
+        int8_t getTh() const {
+            return (int8_t)_scrpd[2];
+        }
+
+        /** @see Scratchpad::getTl() */
+        int8_t getTl() const {
+            return (int8_t)_scrpd[3];
+        }
+
+        /** @see Scratchpad::setThl() */
+        void setThl(int8_t th, int8_t tl)
+        {
+            _scrpd[2] = (uint8_t)th;
+            _scrpd[3] = (uint8_t)tl;
+            _updateCrc();
+        }
+
+        /** @see Scratchpad::getResolution() */
+        Resolution getResolution() const {
+            if ((*_id)[0] != DS18S20)
+                return (Resolution)(RES_9_BIT + ((_scrpd[4] >> 5) & 3));
+            else
+                return RES_9_BIT;
+        }
+
+        /** @see Scratchpad::setResolution() */
+        void setResolution(Resolution res)
+        {
+            if ((*_id)[0] != DS18S20) {
+                _scrpd[4] &= 0x9f;
+                _scrpd[4] |= (uint8_t)(((res - RES_9_BIT) & 3) << 5);
+                _updateCrc();
+            }
+        }
+
+        /** @see Scratchpad::getAddr() */
+        uint8_t getAddr() const {
+            return (_scrpd[4] & 0x0f);
+        }
+
+        /** @see Scratchpad::setAddr() */
+        void setAddr(uint8_t addr)
+        {
+            if ((*_id)[0] == DS1825) {
+                _scrpd[4] &= 0xf0;
+                _scrpd[4] |= addr & 0x0f;
+                _updateCrc();
+            }
+        }
+
+        /** Get sensor id the scratchpad belongs to. */
+        const OneWireNg::Id& getId() const {
+            return *_id;
+        }
+
+        /** Get scratchpad in a raw format (@ref Scratchpad::LENGTH bytes). */
+        const uint8_t *getRaw() const {
+            return _scrpd;
+        }
+
+    private:
+        void _updateCrc() {
+            _scrpd[Scratchpad::LENGTH - 1] =
+                OneWireNg::crc8(_scrpd, Scratchpad::LENGTH - 1);
+        }
+
+        const OneWireNg::Id *_id;
+        uint8_t *_scrpd;
+    };
+
+    /**
+     * Sensor entry of the resolution-aware conversion schedule (see
+     * @ref startConvertSched()).
+     */
+    struct SchedSensor
+    {
+        /** Sensor id. */
+        OneWireNg::Id id;
+
+        /**
+         * Configured sensor resolution (e.g. as returned by
+         * @ref Scratchpad::getResolution() of the sensor's scratchpad).
+         */
+        Resolution res;
+
+        /**
+         * Set by the scheduler: @c EC_MORE if the sensor's conversion is in
+         * progress, otherwise the result of the sensor's scratchpad read.
+         */
+        OneWireNg::ErrorCode ec;
+
+        /**
+         * Set by the scheduler: measured temperature (as returned by
+         * @ref Scratchpad::getTemp()). Valid if @c ec is @c EC_SUCCESS.
+         */
+        long temp;
+    };
+
+    /**
+     * Learned conversion time entry of a sensor (see @ref setConvEstTable()).
+     */
+    struct ConvEst
+    {
+        /** Sensor id. */
+        OneWireNg::Id id;
+
+        /** Learned conversion time (ms); 0: entry not used. */
+        uint16_t est;
+    };
+
+    /**
+     * Sensor configuration entry (see @ref writeConfig()).
+     */
+    struct SensorConfig
+    {
+        OneWireNg::Id id;   /** sensor id */
+        int8_t th;          /** high alarm trigger */
+        int8_t tl;          /** low alarm trigger */
+        Resolution res;     /** resolution (ignored for DS18S20) */
+    };
+
     /**
      * DSTherm service constructor.
      *
      * @param ow 1-wire service.
      */
-    DSTherm(OneWireNg& ow): _ow(ow) {}
+    DSTherm(OneWireNg& ow): _ow(ow) {
+        _conv.pending = 0;
+        _sched.sensors = NULL;
+        _sched.n = 0;
+        _fullReadPeriod = 0;
+        _fullReadCnt = 0;
+        memset(_nomRes, 0, sizeof(_nomRes));
+        _nomResAll = false;
+        _convEstAll = 0;
+        _convEst = NULL;
+        _convEstN = 0;
+        _convEstNext = 0;
+    }
 
     /**
      * Start temperature conversion on the addressed sensor.
@@ -250,7 +458,14 @@ public:
      * - @c convTime < 0 (use @ref SCAN_BUS constant for this case):
      *   If @c parasitic is @c false (sensor is not parasitically powered)
      *   the routine scans 1-wire bus for conversion completion and returns if
-     *   completed, otherwise waits @c MAX_CONV_TIME and returns.
+     *   completed, otherwise waits @c MAX_CONV_TIME and returns. The bus
+     *   is polled with exponentially increasing period after the nominal
+     *   conversion time (for the resolution last set by @ref
+     *   writeScratchpad() for the sensor family, @c MAX_CONV_TIME if not
+     *   known) or, once learned, after the conversion time learned from
+     *   recent conversions of the sensor(s), to limit the number of read
+     *   slots issued on the bus. Conversion times of individual sensors are
+     *   learned only if @ref setConvEstTable() is configured.
      * @param parasitic If @c true 1-wire bus is powered during the conversion
      *     time.
      *
@@ -273,6 +488,131 @@ public:
         return _convertTemp(NULL, convTime, parasitic);
     }
 
+    /**
+     * Start temperature conversion on the addressed sensor and return
+     * immediately (asynchronous variant of @ref convertTemp()). The conversion
+     * completion is scheduled at @c nowMs + @c convTime and shall be checked
+     * by @ref pollConvert(), therefore the caller may proceed with its tasks
+     * while the conversion is in progress.
+     *
+     * @param id Sensor id for temperature conversion.
+     * @param nowMs Current time in milliseconds (e.g. as returned by Arduino
+     *     @c millis()). The same time source shall be used for subsequent
+     *     @ref pollConvert() calls.
+     * @param convTime Conversion time (in milliseconds). If @c SCAN_BUS is
+     *     passed and @c parasitic is @c false, the conversion completion is
+     *     additionally detected by reading the bus on @ref pollConvert() calls
+     *     (the conversion ends not later than in @ref MAX_CONV_TIME). In this
+     *     case there shall be no other activities on the bus until the
+     *     conversion completion.
+     * @param parasitic If @c true 1-wire bus is powered during the conversion
+     *     time (until the completion is reported by @ref pollConvert()).
+     *
+     * @return Error codes:
+     *     - @c EC_SUCCESS: Conversion started.
+     *     - @c EC_NO_DEVS: No devices on the bus.
+     *
+     * @note There may be only one asynchronous conversion in progress for
+     *     the DSTherm service object. Subsequent start overrides the previous
+     *     conversion schedule.
+     */
+    OneWireNg::ErrorCode startConvertTemp(const OneWireNg::Id& id,
+        unsigned long nowMs, int convTime = SCAN_BUS, bool parasitic = false)
+    {
+        return _startConvertTemp(&id, nowMs, convTime, parasitic);
+    }
+
+    /**
+     * Similar to @ref startConvertTemp() but all sensors on the bus are
+     * addressed.
+     */
+    OneWireNg::ErrorCode startConvertTempAll(
+        unsigned long nowMs, int convTime = SCAN_BUS, bool parasitic = false)
+    {
+        return _startConvertTemp(NULL, nowMs, convTime, parasitic);
+    }
+
+    /**
+     * Check the asynchronous conversion (started by @ref startConvertTemp(),
+     * @ref startConvertTempAll()) completion. The routine doesn't block.
+     * In case the conversion completes and the bus was powered for the
+     * conversion time, the bus is de-powered.
+     *
+     * @param nowMs Current time in milliseconds.
+     * @param leftMs If not @c NULL, time left (in milliseconds) to the
+     *     scheduled conversion completion is written under this address
+     *     (0 if the conversion is completed).
+     *
+     * @return Error codes:
+     *     - @c EC_MORE: Conversion in progress.
+     *     - @c EC_SUCCESS (aka @c EC_DONE): Conversion completed (or there is
+     *         no conversion in progress). Temperatures may be read by
+     *         @ref collect() or @ref readScratchpad().
+     */
+    OneWireNg::ErrorCode pollConvert(
+        unsigned long nowMs, unsigned long *leftMs = NULL);
+
+    /**
+     * Read scratchpad of a sensor after the asynchronous conversion
+     * completion.
+     *
+     * @return Error codes as for @ref readScratchpad() and additionally:
+     *     - @c EC_MORE: Conversion still in progress (as reported by the
+     *         last @ref pollConvert() call); the scratchpad is not read.
+     */
+    OneWireNg::ErrorCode collect(
+        const OneWireNg::Id& id, Scratchpad *scratchpad)
+    {
+        return (_conv.pending ?
+            OneWireNg::EC_MORE : readScratchpad(id, scratchpad));
+    }
+
+    /**
+     * Start temperature conversion on all sensors on the bus and schedule
+     * reading of @c n @c sensors as soon as their conversions complete,
+     * according to the sensors family and configured resolution (e.g.
+     * 9-bit sensors are read after 94 ms, while 12-bit ones are still
+     * converting). The schedule is driven by @ref pollSched() calls.
+     *
+     * @param sensors Table of sensors to read. The table shall be valid
+     *     until the schedule completion; the scheduler writes the sensors
+     *     status and temperatures into it.
+     * @param n Number of sensors in the table.
+     * @param nowMs Current time in milliseconds (e.g. as returned by Arduino
+     *     @c millis()). The same time source shall be used for subsequent
+     *     @ref pollSched() calls.
+     *
+     * @return Error codes:
+     *     - @c EC_SUCCESS: Conversion started.
+     *     - @c EC_NO_DEVS: No devices on the bus.
+     *
+     * @note The scheduler communicates with the sensors during the conversion
+     *     time, therefore it's not usable for parasitically powered sensors
+     *     (use @ref convertTempAll() or @ref startConvertTempAll() with
+     *     @c parasitic set in this case).
+     */
+    OneWireNg::ErrorCode startConvertSched(
+        SchedSensor *sensors, size_t n, unsigned long nowMs);
+
+    /**
+     * Drive the conversion schedule started by @ref startConvertSched().
+     * Scratchpads of the sensors with completed conversions are read and
+     * their temperatures written into the schedule table. The routine doesn't
+     * block.
+     *
+     * @param nowMs Current time in milliseconds.
+     * @param leftMs If not @c NULL, time left (in milliseconds) to the next
+     *     scheduled conversion completion is written under this address
+     *     (0 if the schedule is completed).
+     *
+     * @return Error codes:
+     *     - @c EC_MORE: Some sensors' conversions are in progress.
+     *     - @c EC_SUCCESS (aka @c EC_DONE): All scheduled sensors have been
+     *         read (status of each read is available in @c SchedSensor::ec).
+     */
+    OneWireNg::ErrorCode pollSched(
+        unsigned long nowMs, unsigned long *leftMs = NULL);
+
 #define MAKE_SCRATCHPAD(__scrpd) \
     uint8_t __scrpd##_buf[sizeof(DSTherm::Scratchpad)]; \
     DSTherm::Scratchpad *__scrpd = reinterpret_cast<DSTherm::Scratchpad*>(__scrpd##_buf)
@@ -324,6 +664,218 @@ public:
     OneWireNg::ErrorCode readScratchpad(
         const OneWireNg::Id& id, Scratchpad *scratchpad);
 
+    /**
+     * Read sensor scratchpad into caller provided buffer.
+     *
+     * The scratchpad bytes are read directly into @c scrpd (no intermediate
+     * copies) and may be accessed by @ref ScratchpadView.
+     *
+     * @param id Sensor id the scratchpad shall be read from.
+     * @param scrpd Buffer of @ref Scratchpad::LENGTH bytes the scratchpad is
+     *     read into. The buffer content is undefined in case of failure.
+     *
+     * @return Error codes as for @ref readScratchpad(const OneWireNg::Id&,
+     *     Scratchpad*).
+     */
+    OneWireNg::ErrorCode readScratchpad(
+        const OneWireNg::Id& id, uint8_t *scrpd)
+    {
+        return _readScratchpad(id, scrpd, Scratchpad::LENGTH);
+    }
+
+    /**
+     * Read temperature of a sensor (temperature-only scratchpad read).
+     *
+     * The scratchpad read is truncated to the bytes needed for the temperature
+     * decoding (5 bytes including the configuration register, 2 bytes for
+     * DS18S20 or 8 bytes if @ref CONFIG_DS18S20_EXT_RES is configured) and
+     * terminated by a bus reset issued right after the read. Since the
+     * scratchpad CRC is not read, only the fixed bits of the sensor
+     * configuration register are checked (not for DS18S20). Use @ref
+     * setFullReadPeriod() to perform periodic full, CRC validated reads.
+     *
+     * A truncated read can't tell a sensor absent (or dropped off after the
+     * addressing) from all ones sent by the sensor, since the released bus
+     * is read as ones (e.g. 2 bytes temperature of 0xffff decodes to
+     * -0.0625 C). Therefore if the configuration register is not checked, a
+     * truncated read with all bytes read as ones is repeated as the full,
+     * CRC validated read, which fails for the absent sensor with @c
+     * EC_CRC_ERROR.
+     *
+     * @param id Sensor id.
+     * @param temp Read temperature (as returned by @ref Scratchpad::getTemp())
+     *     is written under this address in case of success.
+     *
+     * @return Error codes as for @ref readScratchpad() and additionally:
+     *     - @c EC_BUS_ERROR: Configuration register check failed.
+     */
+    OneWireNg::ErrorCode readTemp(const OneWireNg::Id& id, long *temp) {
+        return _readTemp(id, temp, NULL);
+    }
+
+    /**
+     * Similar to @ref readTemp(const OneWireNg::Id&, long*) but the sensor
+     * resolution @c res is known by the caller (e.g. as configured or cached
+     * from a previous scratchpad read), therefore only 2 bytes of the
+     * temperature are read and no configuration register check is performed.
+     */
+    OneWireNg::ErrorCode readTemp(
+        const OneWireNg::Id& id, Resolution res, long *temp)
+    {
+        return _readTemp(id, temp, &res);
+    }
+
+    /**
+     * Set period of full, CRC validated scratchpad reads performed by
+     * @ref readTemp(): each @c period-th call reads the whole scratchpad.
+     * If 0 (default) no full reads are performed.
+     *
+     * @note The period is counted for all sensors read by the DSTherm
+     *     service object. For round-robin reads of @c n sensors the period
+     *     should be coprime with @c n, so all the sensors are fully read
+     *     in turn.
+     */
+    void setFullReadPeriod(unsigned period) {
+        _fullReadPeriod = period;
+        _fullReadCnt = 0;
+    }
+
+    /**
+     * Set table of @c n entries the conversion times of individual sensors
+     * learned by @ref convertTemp() (@ref SCAN_BUS mode) are kept in. The
+     * table is owned by the caller and shall be valid for the DSTherm
+     * service object lifetime (or until replaced). If not set (default)
+     * individual sensors conversions wait for the nominal conversion time.
+     *
+     * @note For round-robin conversions of @c n sensors the table should
+     *     have @c n entries, since the entries are replaced in round-robin
+     *     manner. A sensor with the entry replaced falls back to the nominal
+     *     conversion time.
+     */
+    void setConvEstTable(ConvEst *tab, size_t n)
+    {
+        _convEst = tab;
+        _convEstN = (tab ? n : 0);
+        _convEstNext = 0;
+        for (size_t i = 0; i < _convEstN; i++)
+            _convEst[i].est = 0;
+    }
+
+    /**
+     * Convert temperature on all sensors on the bus and read temperatures of
+     * @c n sensors with @c ids (pipelined sampling).
+     *
+     * Unless @c validate is @c true, only the scratchpad bytes needed for
+     * the temperature decoding are read (the read is truncated): 5 bytes
+     * (2 bytes for DS18S20, 8 if @ref CONFIG_DS18S20_EXT_RES is configured)
+     * instead of full 9 bytes scratchpad and its CRC validation is not
+     * possible. In this case only the fixed bits of the sensor configuration
+     * register are checked (not for DS18S20).
+     *
+     * @param ids Table of sensors ids to read.
+     * @param n Number of sensors in the @c ids table.
+     * @param temps Output table of @c n read temperatures (as returned by
+     *     @ref Scratchpad::getTemp()). An element is written only if the
+     *     corresponding sensor has been successfully read.
+     * @param ecs If not @c NULL, output table of @c n reads statuses (error
+     *     codes as for @ref readScratchpad() and @c EC_BUS_ERROR for failed
+     *     configuration register check). All elements are written; sensors
+     *     not read due to no devices on the bus are marked @c EC_NO_DEVS.
+     * @param validate If @c true full scratchpad is read and its CRC is
+     *     validated.
+     * @param convTime, parasitic See @ref convertTemp().
+     *
+     * @return Error codes:
+     *     - @c EC_SUCCESS: All sensors successfully read.
+     *     - @c EC_NO_DEVS: No devices on the bus.
+     *     - Otherwise: Error code of the first failed sensor read (see
+     *         @c ecs for particular sensors statuses).
+     */
+    OneWireNg::ErrorCode sampleAll(const OneWireNg::Id *ids, size_t n,
+        long *temps, OneWireNg::ErrorCode *ecs = NULL, bool validate = false,
+        int convTime = SCAN_BUS, bool parasitic = false);
+
+    /**
+     * Convert temperature on all sensors on the bus and read temperatures of
+     * the sensors in the alarm state only (event mode).
+     *
+     * After the conversion, a sensor is in the alarm state if the measured
+     * temperature is higher or equal to its Th or lower or equal to its Tl
+     * alarm trigger. The alarm triggers are programmed per sensor by
+     * @ref writeScratchpad() (or for all sensors by
+     * @ref writeScratchpadAll()). The alarming sensors are detected by the
+     * conditional search (see @ref OneWireNg::searchAll()), therefore only
+     * their scratchpads are read and the bus time of a sampling cycle scales
+     * with the number of alarms, not the number of sensors on the bus.
+     *
+     * The scratchpads reads are performed as for @ref sampleAll().
+     *
+     * @param ids Output table the alarming sensors ids are written into.
+     * @param max Max. number of ids the @c ids table is able to hold.
+     * @param found If not @c NULL, written with the number of alarming
+     *     sensors written into the @c ids table.
+     * @param temps Output table of read temperatures (@c max elements) of
+     *     the alarming sensors (as returned by @ref Scratchpad::getTemp()).
+     *     An element is written only if the corresponding sensor has been
+     *     successfully read.
+     * @param ecs, validate, convTime, parasitic See @ref sampleAll().
+     *
+     * @return Error codes:
+     *     - @c EC_SUCCESS: Alarming sensors (if any) successfully read.
+     *     - @c EC_NO_DEVS: No devices on the bus.
+     *     - @c EC_FULL: The @c ids table is full and there are more alarming
+     *         sensors. The sensors written into the table are read.
+     *     - Otherwise: Error code of the search or the first failed sensor
+     *         read (see @c ecs for particular sensors statuses).
+     */
+    OneWireNg::ErrorCode sampleAlarms(OneWireNg::Id *ids, size_t max,
+        size_t *found, long *temps, OneWireNg::ErrorCode *ecs = NULL,
+        bool validate = false, int convTime = SCAN_BUS, bool parasitic = false);
+
+    /**
+     * Decode temperature from raw scratchpad bytes @c scrpd of a sensor
+     * with a given @c id. Result as returned by @ref Scratchpad::getTemp().
+     *
+     * @note Bytes 0-1 and 4 (configuration register) are needed for the
+     *     decoding. For DS18S20 bytes 0-1 (and bytes 6-7 if
+     *     @ref CONFIG_DS18S20_EXT_RES is configured).
+     */
+    static long decodeTemp(const OneWireNg::Id& id, const uint8_t *scrpd);
+
+    /**
+     * Decode temperature from raw scratchpad bytes @c scrpd of a sensor
+     * with a given @c id. Result as returned by @ref Scratchpad::getTempQ8().
+     *
+     * As opposed to @ref decodeTemp() the decoding is performed on 16-bit
+     * integers by shifts only (no multiplications nor divisions), therefore
+     * is considerably cheaper on 8-bit platforms.
+     */
+    static int16_t decodeTempQ8(const OneWireNg::Id& id, const uint8_t *scrpd);
+
+    /**
+     * Decode temperature from raw scratchpad bytes @c scrpd of a sensor
+     * with a given @c id. Result as returned by
+     * @ref Scratchpad::getTempCenti().
+     */
+    static int16_t decodeTempCenti(
+        const OneWireNg::Id& id, const uint8_t *scrpd);
+
+    /**
+     * Batch variant of @ref decodeTempQ8(). Decode temperatures of @c n
+     * sensors with ids @c ids from raw scratchpads @c scrpds (@c n
+     * consecutive scratchpads, @ref Scratchpad::LENGTH bytes each) into
+     * @c temps.
+     */
+    static void decodeTempQ8(const OneWireNg::Id *ids,
+        const uint8_t *scrpds, size_t n, int16_t *temps);
+
+    /**
+     * Batch variant of @ref decodeTempCenti().
+     * @see decodeTempQ8(const OneWireNg::Id*, const uint8_t*, size_t, int16_t*)
+     */
+    static void decodeTempCenti(const OneWireNg::Id *ids,
+        const uint8_t *scrpds, size_t n, int16_t *temps);
+
     /**
      * Write whole thermometer configuration to a given sensor.
      * @see Scratchpad::writeScratchpad() to set only specific configuration
@@ -347,6 +899,18 @@ public:
         return _writeScratchpad(&id, th, tl, res, addr);
     }
 
+    /**
+     * Write configuration part of the scratchpad referred by a view into
+     * the sensor owning the scratchpad.
+     * @see Scratchpad::writeScratchpad()
+     */
+    OneWireNg::ErrorCode writeScratchpad(const ScratchpadView& scrpd)
+    {
+        const uint8_t *raw = scrpd.getRaw();
+        return _writeScratchpad(&scrpd.getId(), (int8_t)raw[2], (int8_t)raw[3],
+            (uint8_t)((raw[4] >> 5) & 3), (uint8_t)(raw[4] & 0x0f));
+    }
+
     /**
      * Similar to @ref DSTherm::writeScratchpad() but all sensors on the bus
      * are addressed.
@@ -398,6 +962,52 @@ public:
         return _copyScratchpad(NULL, parasitic, copyTime);
     }
 
+    /**
+     * Write configuration of @c n sensors (batch configuration).
+     *
+     * Each sensor is addressed individually; sensors not present in the
+     * @c cfgs table are not affected. If @c copy is @c true the
+     * configuration is copied to EEPROM of each of the sensors. Use
+     * @ref writeConfigAll() if the table covers all sensors on the bus.
+     *
+     * @param cfgs Table of @c n sensors configurations.
+     * @param n Number of entries in the @c cfgs table.
+     * @param copy If @c true the configuration is copied to EEPROM.
+     * @param parasitic, copyTime See @ref copyScratchpad().
+     *
+     * @return Error codes:
+     *     - @c EC_SUCCESS: Operation finished with success.
+     *     - @c EC_NO_DEVS: No devices on the bus.
+     */
+    OneWireNg::ErrorCode writeConfig(const SensorConfig *cfgs, size_t n,
+        bool copy = false, bool parasitic = false,
+        int copyTime = COPY_SCRATCHPAD_TIME)
+    {
+        return _writeConfig(cfgs, n, false, copy, parasitic, copyTime);
+    }
+
+    /**
+     * Similar to @ref writeConfig() but the @c cfgs table shall cover all
+     * sensors connected to the bus.
+     *
+     * The sensors are grouped by identical settings. The most common
+     * settings are broadcast to all sensors on the bus by a single
+     * @ref writeScratchpadAll() command, next the remaining sensors are
+     * addressed individually. If @c copy is @c true the configuration is
+     * copied to EEPROM of all sensors by a single @ref copyScratchpadAll()
+     * command (with a single wait for the copy completion).
+     *
+     * @warning Sensors on the bus not present in the @c cfgs table are
+     *     configured with the broadcast settings (and have them copied to
+     *     EEPROM if @c copy is @c true).
+     */
+    OneWireNg::ErrorCode writeConfigAll(const SensorConfig *cfgs, size_t n,
+        bool copy = false, bool parasitic = false,
+        int copyTime = COPY_SCRATCHPAD_TIME)
+    {
+        return _writeConfig(cfgs, n, true, copy, parasitic, copyTime);
+    }
+
     /**
      * For specific sensor recall thermometer configuration from EEPROM
      * and place it in the scratchpad.
@@ -476,6 +1086,15 @@ public:
         return ret;
     }
 
+    /**
+     * Get conversion time (in milliseconds) for a given sensor @c id and its
+     * configured measurement resolution. DS18S20 conversion time doesn't
+     * depend on the resolution (@ref MAX_CONV_TIME is returned).
+     */
+    static int getConversionTime(const OneWireNg::Id& id, Resolution res) {
+        return (id[0] == DS18S20 ? MAX_CONV_TIME : getConversionTime(res));
+    }
+
     /** Max conversion time (12 bits resolution) in milliseconds */
     const static int MAX_CONV_TIME = 750;
 
@@ -504,7 +1123,26 @@ public:
     const static uint8_t DS28EA00 = 0x42;
 
 private:
-    void _waitForCompletion(int ms, bool parasitic, int scanTimeoutMs);
+    /*
+     * Write function command; for parasitic mode the bus is powered right
+     * after the command.
+     */
+    void _writeCmd(uint8_t cmd, bool parasitic)
+    {
+        if (parasitic)
+            _ow.writeBytePwr(cmd);
+        else
+            _ow.writeByte(cmd);
+    }
+
+    void _waitForCompletion(int ms, bool parasitic,
+        int scanTimeoutMs, const OneWireNg::Id *id = NULL);
+
+    uint16_t *_convEstGet(const OneWireNg::Id *id, bool alloc);
+
+    int _convNominal(const OneWireNg::Id *id);
+
+    void _convSetRes(const OneWireNg::Id *id, Resolution res);
 
     OneWireNg::ErrorCode _convertTemp(
         const OneWireNg::Id *id, int convTime, bool parasitic)
@@ -513,14 +1151,29 @@ private:
             (id ? _ow.addressSingle(*id) : _ow.addressAll());
 
         if (ec == OneWireNg::EC_SUCCESS) {
-            _ow.writeByte(CMD_CONVERT_T);
+            _writeCmd(CMD_CONVERT_T, parasitic);
             _waitForCompletion(
                 (convTime < 0 && parasitic ? MAX_CONV_TIME : convTime),
-                parasitic, MAX_CONV_TIME);
+                parasitic, MAX_CONV_TIME, id);
         }
         return ec;
     }
 
+    OneWireNg::ErrorCode _readScratchpad(
+        const OneWireNg::Id& id, uint8_t *scrpd, size_t len);
+
+    OneWireNg::ErrorCode _writeConfig(const SensorConfig *cfgs, size_t n,
+        bool all, bool copy, bool parasitic, int copyTime);
+
+    OneWireNg::ErrorCode _readTemp(const OneWireNg::Id& id,
+        long *temp, const Resolution *res, bool full);
+
+    OneWireNg::ErrorCode _readTemp(
+        const OneWireNg::Id& id, long *temp, const Resolution *res);
+
+    OneWireNg::ErrorCode _startConvertTemp(const OneWireNg::Id *id,
+        unsigned long nowMs, int convTime, bool parasitic);
+
     OneWireNg::ErrorCode _writeScratchpad(const OneWireNg::Id *id,
         int8_t th, int8_t tl, uint8_t res, uint8_t addr);
 
@@ -531,7 +1184,7 @@ private:
             (id ? _ow.addressSingle(*id) : _ow.addressAll());
 
         if (ec == OneWireNg::EC_SUCCESS) {
-            _ow.writeByte(CMD_COPY_SCRATCHPAD);
+            _writeCmd(CMD_COPY_SCRATCHPAD, parasitic);
             _waitForCompletion((copyTime <= 0 ? 0 : copyTime),
                 parasitic, 0 /* not used */);
         }
@@ -570,6 +1223,49 @@ private:
     static FamilyCodeName FAMILY_NAMES[];
 
     OneWireNg& _ow;
+
+    /* asynchronous conversion state */
+    struct {
+        unsigned pending:   1;  /** conversion in progress */
+        unsigned parasitic: 1;  /** bus powered for the conversion time */
+        unsigned scan:      1;  /** completion detected by reading the bus */
+        unsigned long start;    /** conversion start time (ms) */
+        unsigned long time;     /** conversion time (ms) */
+    } _conv;
+
+    /* resolution-aware conversion schedule */
+    struct {
+        SchedSensor *sensors;
+        size_t n;
+        unsigned long start;    /** conversion start time (ms) */
+    } _sched;
+
+    /* readTemp() full reads period and counter */
+    unsigned _fullReadPeriod;
+    unsigned _fullReadCnt;
+
+    /** Max. bus polling period while scanning for conversion completion */
+    const static int SCAN_MAX_PERIOD = 8;
+
+    /** Families with configurable resolution */
+    const static int RES_FAMILIES = 4;
+
+    /*
+     * Resolution last set per family with configurable resolution (0: not
+     * known, otherwise resolution + 1) and if set for all sensors on the bus.
+     */
+    uint8_t _nomRes[RES_FAMILIES];
+    bool _nomResAll;
+
+    /*
+     * Conversion times learned while scanning the bus for the conversion
+     * completion: all sensors conversion and caller's table of individual
+     * sensors (0: not learned).
+     */
+    uint16_t _convEstAll;
+    ConvEst *_convEst;
+    size_t _convEstN;
+    size_t _convEstNext;
 };
 
 #endif /* __OWNG_DSTHERM__ */
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include "drivers/DSThermCache.h"
+
+/*
+ * Configuration register bits meaningful for a given sensor type:
+ * resolution (not for DS18S20) and address (DS1825 only).
+ */
+static uint8_t cfgMask(const OneWireNg::Id& id)
+{
+    return (id[0] == DSTherm::DS18S20 ? 0 :
+        (id[0] == DSTherm::DS1825 ? 0x6f : 0x60));
+}
+
+DSThermCache::Entry *DSThermCache::_find(const OneWireNg::Id& id)
+{
+    for (size_t i = 0; i < _n; i++) {
+        if (_entries[i].flgs.valid &&
+            !memcmp(_entries[i].id, id, sizeof(OneWireNg::Id)))
+        {
+            return &_entries[i];
+        }
+    }
+    return NULL;
+}
+
+OneWireNg::ErrorCode DSThermCache::_load(
+    const OneWireNg::Id& id, Entry **entry)
+{
+    OneWireNg::ErrorCode ec = OneWireNg::EC_SUCCESS;
+    Entry *e = _find(id);
+
+    if (!e) {
+        /* not cached; look for a free entry */
+        for (size_t i = 0; i < _n; i++) {
+            if (!_entries[i].flgs.valid) {
+                e = &_entries[i];
+                break;
+            }
+        }
+
+        uint8_t scrpd[DSTherm::Scratchpad::LENGTH];
+        ec = _dsth.readScratchpad(id, scrpd);
+
+        if (e) {
+            if (ec == OneWireNg::EC_SUCCESS) {
+                memcpy(e->id, id, sizeof(OneWireNg::Id));
+                memcpy(e->cfg, &scrpd[2], sizeof(e->cfg));
+                e->flgs.valid = 1;
+                e->flgs.dirty = 0;
+            } else {
+                e = NULL;
+            }
+        } else
+        if (ec == OneWireNg::EC_SUCCESS) {
+            /* no free entry; use caller's temporary entry */
+            memcpy((*entry)->cfg, &scrpd[2], sizeof((*entry)->cfg));
+            (*entry)->flgs.valid = 0;
+            (*entry)->flgs.dirty = 0;
+            return ec;
+        }
+    }
+
+    if (e) *entry = e;
+    return ec;
+}
+
+OneWireNg::ErrorCode DSThermCache::getConfig(const OneWireNg::Id& id,
+    int8_t *th, int8_t *tl, DSTherm::Resolution *res, unsigned *addr)
+{
+    Entry tmp;
+    Entry *e = &tmp;
+
+    OneWireNg::ErrorCode ec = _load(id, &e);
+    if (ec == OneWireNg::EC_SUCCESS)
+    {
+        if (th) *th = (int8_t)e->cfg[0];
+        if (tl) *tl = (int8_t)e->cfg[1];
+        if (res) {
+            *res = (id[0] != DSTherm::DS18S20 ?
+                (DSTherm::Resolution)((e->cfg[2] >> 5) & 3) :
+                DSTherm::RES_9_BIT);
+        }
+        if (addr) *addr = (e->cfg[2] & 0x0f);
+    }
+    return ec;
+}
+
+OneWireNg::ErrorCode DSThermCache::setConfig(const OneWireNg::Id& id,
+    int8_t th, int8_t tl, uint8_t res, uint8_t addr)
+{
+    Entry tmp;
+    Entry *e = &tmp;
+
+    OneWireNg::ErrorCode ec = _load(id, &e);
+    if (ec == OneWireNg::EC_SUCCESS)
+    {
+        uint8_t mask = cfgMask(id);
+        uint8_t cfg = (uint8_t)((((res - DSTherm::RES_9_BIT) & 3) << 5) |
+            0x10 | (addr & 0x0f));
+
+        if ((int8_t)e->cfg[0] == th && (int8_t)e->cfg[1] == tl &&
+            !((e->cfg[2] ^ cfg) & mask))
+        {
+            /* no change */
+            return ec;
+        }
+
+        ec = _dsth.writeScratchpad(id, th, tl, res, addr);
+        if (e == &tmp) {
+            /* not cached; the scratchpad may have been changed */
+            _dirtyUncached = true;
+        } else
+        if (ec == OneWireNg::EC_SUCCESS) {
+            e->cfg[0] = (uint8_t)th;
+            e->cfg[1] = (uint8_t)tl;
+            e->cfg[2] = (uint8_t)((e->cfg[2] & ~mask) | (cfg & mask));
+            e->flgs.dirty = 1;
+        } else {
+            /* sensor state is unknown */
+            _invalidate(*e);
+        }
+    }
+    return ec;
+}
+
+OneWireNg::ErrorCode DSThermCache::writeBack(
+    const OneWireNg::Id& id, bool parasitic, int copyTime)
+{
+    OneWireNg::ErrorCode ec = OneWireNg::EC_SUCCESS;
+    Entry *e = _find(id);
+
+    if (e ? e->flgs.dirty : _dirtyUncached) {
+        ec = _dsth.copyScratchpad(id, parasitic, copyTime);
+        if (ec == OneWireNg::EC_SUCCESS && e)
+            e->flgs.dirty = 0;
+    }
+    return ec;
+}
+
+OneWireNg::ErrorCode DSThermCache::writeBackAll(bool parasitic, int copyTime)
+{
+    OneWireNg::ErrorCode ec = OneWireNg::EC_SUCCESS;
+    bool dirty = _dirtyUncached;
+
+    for (size_t i = 0; i < _n && !dirty; i++)
+        dirty = (_entries[i].flgs.valid && _entries[i].flgs.dirty);
+
+    if (dirty) {
+        ec = _dsth.copyScratchpadAll(parasitic, copyTime);
+        if (ec == OneWireNg::EC_SUCCESS) {
+            for (size_t i = 0; i < _n; i++) {
+                if (_entries[i].flgs.valid)
+                    _entries[i].flgs.dirty = 0;
+            }
+            _dirtyUncached = false;
+        }
+    }
+    return ec;
+}
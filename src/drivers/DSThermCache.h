@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __OWNG_DSTHERM_CACHE__
+#define __OWNG_DSTHERM_CACHE__
+
+#include "drivers/DSTherm.h"
+
+/**
+ * Dallas thermometers configuration cache.
+ *
+ * The class keeps the last known configuration (scratchpad bytes 2-4: Th,
+ * Tl and configuration register) of the cached sensors, therefore:
+ * - The configuration is read from a sensor only once (on the first access).
+ * - The configuration is written to a sensor only if it changes.
+ * - The configuration is copied to a sensor's EEPROM on demand, only if
+ *   it has been changed since the last copy (write-back).
+ *
+ * The cache entries are stored in a caller provided table. If the table is
+ * full, not cached sensors are accessed directly on the bus.
+ *
+ * @note The cache is not aware of the sensors configuration changed by
+ *     @ref DSTherm routines called directly (e.g. @c writeScratchpad(),
+ *     @c recallEeprom()). Use @ref invalidate() in this case.
+ */
+class DSThermCache
+{
+public:
+    /**
+     * Cache entry.
+     */
+    struct Entry
+    {
+        OneWireNg::Id id;       /** sensor id */
+        uint8_t cfg[3];         /** cached scratchpad bytes 2-4 */
+        struct {
+            unsigned valid: 1;  /** entry is valid */
+            unsigned dirty: 1;  /** configuration not copied to EEPROM */
+        } flgs;
+    };
+
+    /**
+     * DSThermCache constructor.
+     *
+     * @param dsth Dallas thermometers service.
+     * @param entries Table of @c n cache entries.
+     * @param n Number of cache entries.
+     */
+    DSThermCache(DSTherm& dsth, Entry *entries, size_t n):
+        _dsth(dsth), _entries(entries), _n(n), _dirtyUncached(false)
+    {
+        for (size_t i = 0; i < _n; i++) {
+            _entries[i].flgs.valid = 0;
+            _entries[i].flgs.dirty = 0;
+        }
+    }
+
+    /**
+     * Get configuration of a sensor with a given @c id. The configuration
+     * is read from the sensor if not cached.
+     *
+     * @param id Sensor id.
+     * @param th, tl, res, addr If not @c NULL, the configuration parameters
+     *     (as for @ref DSTherm::writeScratchpad()) are written under these
+     *     addresses.
+     *
+     * @return Error codes:
+     *     - @c EC_SUCCESS: Operation finished with success.
+     *     - Otherwise: Error code of the scratchpad read
+     *         (see @ref DSTherm::readScratchpad()).
+     */
+    OneWireNg::ErrorCode getConfig(const OneWireNg::Id& id, int8_t *th,
+        int8_t *tl, DSTherm::Resolution *res = NULL, unsigned *addr = NULL);
+
+    /**
+     * Set configuration of a sensor with a given @c id. The configuration
+     * is written to the sensor only if it differs from the cached one (the
+     * configuration is read from the sensor if not cached).
+     *
+     * If the sensor can't be cached (no free entry) the change is recorded
+     * as pending for all not cached sensors (see @ref writeBack()).
+     *
+     * @param id Sensor id.
+     * @param th, tl, res, addr See @ref DSTherm::writeScratchpad().
+     *
+     * @return Error codes:
+     *     - @c EC_SUCCESS: Operation finished with success.
+     *     - Otherwise: Error code of the scratchpad read or write.
+     */
+    OneWireNg::ErrorCode setConfig(const OneWireNg::Id& id, int8_t th,
+        int8_t tl, uint8_t res = DSTherm::RES_12_BIT, uint8_t addr = 15);
+
+    /**
+     * Copy configuration of a sensor with a given @c id to its EEPROM if the
+     * configuration has been changed by @ref setConfig() since the last copy.
+     * For a not cached sensor the copy is performed if there is a pending
+     * change of any not cached sensor (such change is cleared by @ref
+     * writeBackAll() only).
+     *
+     * @param id Sensor id.
+     * @param parasitic, copyTime See @ref DSTherm::copyScratchpad().
+     *
+     * @return Error codes:
+     *     - @c EC_SUCCESS: Operation finished with success (or not needed).
+     *     - Otherwise: Error code of @ref DSTherm::copyScratchpad().
+     */
+    OneWireNg::ErrorCode writeBack(const OneWireNg::Id& id,
+        bool parasitic = false, int copyTime = DSTherm::COPY_SCRATCHPAD_TIME);
+
+    /**
+     * Similar to @ref writeBack() but performed for all sensors with
+     * a single @ref DSTherm::copyScratchpadAll() command (if any of the
+     * cached sensors needs the copy or there is a pending change of not
+     * cached sensors).
+     *
+     * @note All sensors on the bus copy their scratchpads to EEPROM.
+     */
+    OneWireNg::ErrorCode writeBackAll(
+        bool parasitic = false, int copyTime = DSTherm::COPY_SCRATCHPAD_TIME);
+
+    /**
+     * Check if configuration of a sensor with a given @c id has been changed
+     * but not copied to its EEPROM yet. For a not cached sensor @c true is
+     * returned if there is a pending change of any not cached sensor.
+     */
+    bool isDirty(const OneWireNg::Id& id) {
+        Entry *e = _find(id);
+        return (e ? e->flgs.dirty : _dirtyUncached);
+    }
+
+    /**
+     * Invalidate cache entry of a sensor with a given @c id. Not copied
+     * change of the sensor configuration becomes pending change of not
+     * cached sensors.
+     */
+    void invalidate(const OneWireNg::Id& id) {
+        Entry *e = _find(id);
+        if (e) _invalidate(*e);
+    }
+
+    /**
+     * Invalidate all cache entries.
+     *
+     * @see invalidate()
+     */
+    void invalidateAll() {
+        for (size_t i = 0; i < _n; i++)
+            _invalidate(_entries[i]);
+    }
+
+private:
+    /**
+     * Find valid cache entry for a given sensor @c id.
+     * @c NULL returned if not found.
+     */
+    Entry *_find(const OneWireNg::Id& id);
+
+    /**
+     * Get cache entry for a given sensor @c id. The sensor configuration is
+     * read into a free entry if the sensor is not cached. On input @c entry
+     * points to a caller's temporary entry, which is used if there is no
+     * free entry in the cache.
+     */
+    OneWireNg::ErrorCode _load(const OneWireNg::Id& id, Entry **entry);
+
+    void _invalidate(Entry& e) {
+        if (e.flgs.valid && e.flgs.dirty)
+            _dirtyUncached = true;
+        e.flgs.valid = 0;
+    }
+
+    DSTherm& _dsth;
+    Entry *_entries;
+    size_t _n;
+
+    /** configuration of not cached sensor(s) not copied to EEPROM */
+    bool _dirtyUncached;
+};
+
+#endif /* __OWNG_DSTHERM_CACHE__ */
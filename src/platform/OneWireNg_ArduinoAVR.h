@@ -15,7 +15,8 @@
 
 #include <assert.h>
 #include "Arduino.h"
-#include "OneWireNg_BitBang.h"
+#include "OneWireNg_BitBangT.h"
+#include "OneWireNg_BitBangMultiT.h"
 
 #ifdef CONFIG_OVERDRIVE_ENABLED
 # if (F_CPU < 16000000L)
@@ -45,8 +46,10 @@
 /**
  * Arduino AVR platform GPIO specific implementation.
  */
-class OneWireNg_ArduinoAVR: public OneWireNg_BitBang
+class OneWireNg_ArduinoAVR: public OneWireNg_BitBangT<OneWireNg_ArduinoAVR>
 {
+    friend class OneWireNg_BitBangT<OneWireNg_ArduinoAVR>;
+
 public:
     /**
      * OneWireNg 1-wire service for Arduino AVR platform.
@@ -59,7 +62,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoAVR(unsigned pin, bool pullUp):
-        OneWireNg_BitBang(false)
+        OneWireNg_BitBangT<OneWireNg_ArduinoAVR>(false)
     {
         initDtaGpio(pin, pullUp);
     }
@@ -69,7 +72,7 @@ public:
      *
      * Bus powering is supported via a switching transistor providing
      * the power to the bus and controlled by a dedicated GPIO (@see
-     * OneWireNg_BitBang::setupPwrCtrlGpio()). In this configuration the
+     * OneWireNg_BitBangT::setupPwrCtrlGpio()). In this configuration the
      * service mimics the open-drain type of output. The approach may be
      * feasible if the GPIO is unable to provide sufficient power for
      * connected slaves working in parasite powering configuration.
@@ -80,7 +83,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoAVR(unsigned pin, unsigned pwrCtrlPin, bool pullUp):
-        OneWireNg_BitBang(true)
+        OneWireNg_BitBangT<OneWireNg_ArduinoAVR>(true)
     {
         initDtaGpio(pin, pullUp);
         initPwrCtrlGpio(pwrCtrlPin);
@@ -183,6 +186,75 @@ protected:
     } _pwrCtrlGpio;
 };
 
+/**
+ * Arduino AVR platform port-parallel bit-banging of up to 8 1-wire buses
+ * (see @ref OneWireNg_BitBangMultiT).
+ */
+class OneWireNg_ArduinoAVR_Multi:
+    public OneWireNg_BitBangMultiT<OneWireNg_ArduinoAVR_Multi, uint8_t>
+{
+    friend class OneWireNg_BitBangMultiT<OneWireNg_ArduinoAVR_Multi, uint8_t>;
+
+public:
+    /**
+     * OneWireNg_ArduinoAVR_Multi service for Arduino AVR platform.
+     *
+     * @param pins Table of @c n Arduino GPIO pin numbers used for
+     *     bit-banging 1-wire buses. All the pins must belong to the same
+     *     GPIO port. n-th pin is the data GPIO of n-th bus.
+     * @param n Number of pins (max. 8).
+     * @param pullUp If @c true configure internal pull-up resistors for
+     *     the buses.
+     */
+    OneWireNg_ArduinoAVR_Multi(const unsigned *pins, int n, bool pullUp)
+    {
+        assert(n > 0 && n <= MAX_BUSES);
+
+        uint8_t port = digitalPinToPort(pins[0]);
+        assert(port != NOT_A_PIN);
+
+        _inReg = portInputRegister(port);
+        _outReg = portOutputRegister(port);
+        _modReg = portModeRegister(port);
+        _pullUp = 0;
+
+        for (int i = 0; i < n; i++) {
+            assert(digitalPinToPort(pins[i]) == port);
+            if (pullUp)
+                _pullUp |= digitalPinToBitMask(pins[i]);
+            addBus(digitalPinToBitMask(pins[i]));
+        }
+    }
+
+protected:
+    uint8_t readPortIn() {
+        return *_inReg;
+    }
+
+    void setPortAsInput(uint8_t m)
+    {
+        *_modReg &= ~m;
+        /* writing the output register when the GPIO is set
+           in the input mode configures its pull-up resistor */
+        *_outReg = (uint8_t)((*_outReg & ~m) | (_pullUp & m));
+    }
+
+    void setPortAsOutput(uint8_t m, int state)
+    {
+        if (state) {
+            *_outReg |= m;
+        } else {
+            *_outReg &= ~m;
+        }
+        *_modReg |= m;
+    }
+
+    volatile uint8_t *_inReg;
+    volatile uint8_t *_outReg;
+    volatile uint8_t *_modReg;
+    uint8_t _pullUp;
+};
+
 #undef __GPIO_AS_OUTPUT
 #undef __GPIO_AS_INPUT
 #undef __WRITE_GPIO
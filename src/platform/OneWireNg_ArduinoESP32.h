@@ -15,7 +15,8 @@
 
 #include <assert.h>
 #include "Arduino.h"
-#include "OneWireNg_BitBang.h"
+#include "OneWireNg_BitBangT.h"
+#include "OneWireNg_BitBangMultiT.h"
 
 /* determine if target is ESP32-C3 */
 #ifdef CONFIG_IDF_TARGET_ESP32C3
@@ -46,8 +47,10 @@
 /**
  * Arduino ESP32 platform GPIO specific implementation.
  */
-class OneWireNg_ArduinoESP32: public OneWireNg_BitBang
+class OneWireNg_ArduinoESP32: public OneWireNg_BitBangT<OneWireNg_ArduinoESP32>
 {
+    friend class OneWireNg_BitBangT<OneWireNg_ArduinoESP32>;
+
 public:
     /**
      * OneWireNg 1-wire service for Arduino ESP32 platform.
@@ -60,7 +63,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoESP32(unsigned pin, bool pullUp):
-        OneWireNg_BitBang(false)
+        OneWireNg_BitBangT<OneWireNg_ArduinoESP32>(false)
     {
         initDtaGpio(pin, pullUp);
     }
@@ -70,7 +73,7 @@ public:
      *
      * Bus powering is supported via a switching transistor providing
      * the power to the bus and controlled by a dedicated GPIO (@see
-     * OneWireNg_BitBang::setupPwrCtrlGpio()). In this configuration the
+     * OneWireNg_BitBangT::setupPwrCtrlGpio()). In this configuration the
      * service mimics the open-drain type of output. The approach may be
      * feasible if the GPIO is unable to provide sufficient power for
      * connected slaves working in parasite powering configuration.
@@ -81,7 +84,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoESP32(unsigned pin, unsigned pwrCtrlPin, bool pullUp):
-        OneWireNg_BitBang(true)
+        OneWireNg_BitBangT<OneWireNg_ArduinoESP32>(true)
     {
         initDtaGpio(pin, pullUp);
         initPwrCtrlGpio(pwrCtrlPin);
@@ -222,6 +225,82 @@ private:
     } _pwrCtrlGpio;
 };
 
+/**
+ * Arduino ESP32 platform port-parallel bit-banging of up to 8 1-wire buses
+ * (see @ref OneWireNg_BitBangMultiT).
+ */
+class OneWireNg_ArduinoESP32_Multi:
+    public OneWireNg_BitBangMultiT<OneWireNg_ArduinoESP32_Multi, uint32_t>
+{
+    friend class
+        OneWireNg_BitBangMultiT<OneWireNg_ArduinoESP32_Multi, uint32_t>;
+
+public:
+    /**
+     * OneWireNg_ArduinoESP32_Multi service for Arduino ESP32 platform.
+     *
+     * @param pins Table of @c n Arduino GPIO pin numbers used for
+     *     bit-banging 1-wire buses. All the pins must be lower than 32
+     *     (handled by the same GPIO registers). n-th pin is the data GPIO
+     *     of n-th bus.
+     * @param n Number of pins (max. 8).
+     * @param pullUp If @c true configure internal pull-up resistors for
+     *     the buses.
+     */
+    OneWireNg_ArduinoESP32_Multi(const unsigned *pins, int n, bool pullUp)
+    {
+        assert(n > 0 && n <= MAX_BUSES);
+
+#if IDF_IS_TARGET_ESP32C3
+        _inReg = (volatile uint32_t*)(GPIO_IN_REG);
+        _outSetReg = (volatile uint32_t*)(GPIO_OUT_W1TS_REG);
+        _outClrReg = (volatile uint32_t*)(GPIO_OUT_W1TC_REG);
+        _modSetReg = (volatile uint32_t*)(GPIO_ENABLE_W1TS_REG);
+        _modClrReg = (volatile uint32_t*)(GPIO_ENABLE_W1TC_REG);
+#else
+        _inReg = &GPIO.in;
+        _outSetReg = &GPIO.out_w1ts;
+        _outClrReg = &GPIO.out_w1tc;
+        _modSetReg = &GPIO.enable_w1ts;
+        _modClrReg = &GPIO.enable_w1tc;
+#endif
+        for (int i = 0; i < n; i++) {
+#if IDF_IS_TARGET_ESP32C3
+            assert(pins[i] > 0 && pins[i] < 22);
+#else
+            assert(pins[i] < 32);
+#endif
+            pinMode(pins[i], INPUT | (pullUp ? PULLUP : 0));
+            addBus((uint32_t)(1UL << pins[i]));
+        }
+    }
+
+protected:
+    uint32_t readPortIn() {
+        return *_inReg;
+    }
+
+    void setPortAsInput(uint32_t m) {
+        *_modClrReg = m;
+    }
+
+    void setPortAsOutput(uint32_t m, int state)
+    {
+        if (state) {
+            *_outSetReg = m;
+        } else {
+            *_outClrReg = m;
+        }
+        *_modSetReg = m;
+    }
+
+    volatile uint32_t *_inReg;
+    volatile uint32_t *_outSetReg;
+    volatile uint32_t *_outClrReg;
+    volatile uint32_t *_modSetReg;
+    volatile uint32_t *_modClrReg;
+};
+
 #undef __GPIO_AS_OUTPUT
 #undef __GPIO_AS_INPUT
 #undef __WRITE_GPIO
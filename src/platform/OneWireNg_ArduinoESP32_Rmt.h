@@ -0,0 +1,426 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#ifndef __OWNG_ARDUINO_ESP32_RMT__
+#define __OWNG_ARDUINO_ESP32_RMT__
+
+#include <assert.h>
+#include "Arduino.h"
+#include "driver/gpio.h"
+#include "driver/rmt.h"
+#include "freertos/ringbuf.h"
+#include "soc/gpio_sig_map.h"
+#include "OneWireNg.h"
+#include "OneWireNg_Timings.h"
+
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && (ESP_ARDUINO_VERSION_MAJOR >= 2)
+# include "esp_rom_gpio.h"
+# define __GPIO_CONNECT_OUT(pin, sig) \
+    esp_rom_gpio_connect_out_signal(pin, sig, false, false)
+# define __GPIO_CONNECT_IN(pin, sig) \
+    esp_rom_gpio_connect_in_signal(pin, sig, false)
+#else
+# include "rom/gpio.h"
+# define __GPIO_CONNECT_OUT(pin, sig) gpio_matrix_out(pin, sig, false, false)
+# define __GPIO_CONNECT_IN(pin, sig) gpio_matrix_in(pin, sig, false)
+#endif
+
+#ifndef CONFIG_ESP32_RMT_BURST_BYTES
+# define CONFIG_ESP32_RMT_BURST_BYTES 8
+#endif
+
+/* determine if target is ESP32-C3 */
+#ifndef IDF_IS_TARGET_ESP32C3
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+    #define IDF_IS_TARGET_ESP32C3   CONFIG_IDF_TARGET_ESP32C3
+#else
+    #define IDF_IS_TARGET_ESP32C3   0
+#endif
+#endif
+
+/**
+ * Arduino ESP32 platform RMT (remote control peripheral) specific
+ * implementation.
+ *
+ * The 1-wire slots are generated by the RMT TX channel and the bus state is
+ * recorded by the RMT RX channel, both connected to the same (open-drain)
+ * GPIO. Bytes are encoded as sequences of RMT items (one item per slot)
+ * transmitted in bursts of up to @ref CONFIG_ESP32_RMT_BURST_BYTES bytes;
+ * read slots are decoded from the recorded low pulses widths (the slot is
+ * read as 1 if the bus is released before the sampling time). In contrast to
+ * @ref OneWireNg_ArduinoESP32 no interrupts are masked during the 1-wire
+ * activities and the calling task is blocked (not spinning) while a burst
+ * is in progress.
+ *
+ * Byte and multi-byte touching routines transmit whole bursts, the search
+ * triplet is performed in 2 bursts (read slots, direction write). The
+ * routines are used by the library core (e.g. search, addressing) and the
+ * device drivers if the extended virtual interface is enabled (@ref
+ * CONFIG_EXT_VIRTUAL_INTF), otherwise only if called directly on the class
+ * object. Each burst is completed after the bus is idle for @ref RX_IDLE_US
+ * (@ref RX_IDLE_RESET_US for the reset).
+ *
+ * @note The class bases on the legacy ESP-IDF RMT driver (Arduino ESP32 core
+ *     1.x, 2.x). The RX channel uses 2 RMT memory blocks (the subsequent
+ *     channel can't be used), which is sufficient for bursts of 8 bytes.
+ */
+class OneWireNg_ArduinoESP32_Rmt: public OneWireNg
+{
+public:
+    /**
+     * OneWireNg 1-wire service for Arduino ESP32 platform via RMT.
+     *
+     * Bus powering is supported via switching its GPIO to the push-pull
+     * high state.
+     *
+     * @param pin Arduino GPIO pin number of 1-wire bus.
+     * @param pullUp If @c true configure internal pull-up resistor for the bus.
+     * @param txCh RMT channel used for transmission.
+     * @param rxCh RMT channel used for reception. The channel occupies also
+     *     memory block of the subsequent channel (on ESP32-C3 the only valid
+     *     channel is 2).
+     */
+    OneWireNg_ArduinoESP32_Rmt(unsigned pin, bool pullUp,
+        rmt_channel_t txCh = RMT_CHANNEL_0,
+        rmt_channel_t rxCh = RMT_CHANNEL_2):
+        _pin((gpio_num_t)pin), _txCh(txCh), _rxCh(rxCh), _rb(NULL), _pwr(false)
+    {
+        initRmt(pullUp);
+    }
+
+    ~OneWireNg_ArduinoESP32_Rmt()
+    {
+        rmt_driver_uninstall(_txCh);
+        rmt_driver_uninstall(_rxCh);
+    }
+
+    ErrorCode reset()
+    {
+        rmt_item32_t item;
+        unsigned lows, idleUs;
+
+        unpower();
+#ifdef CONFIG_OVERDRIVE_ENABLED
+        if (_overdrive) {
+            setItem(item, OD_RESET_LOW, OD_RESET_SMPL + OD_RESET_END);
+            idleUs = RX_IDLE_US;
+        } else
+#endif
+        {
+            setItem(item, STD_RESET_LOW, STD_RESET_SMPL + STD_RESET_END);
+            idleUs = RX_IDLE_RESET_US;
+        }
+
+        if (xfer(&item, 1, NULL, &lows, idleUs) != ESP_OK)
+            return EC_BUS_ERROR;
+
+        /* the master's reset pulse followed by the presence pulse */
+        return (lows > 1 ? EC_SUCCESS : EC_NO_DEVS);
+    }
+
+    int touchBit(int bit)
+    {
+        uint8_t in = (bit ? 1 : 0), out;
+
+        unpower();
+        touchBitsEng(&in, &out, 1);
+        return out;
+    }
+
+    uint8_t touchByte(uint8_t byte) {
+        uint8_t ret;
+        touchBytesEng(&byte, &ret, 1);
+        return ret;
+    }
+
+    void touchBytes(uint8_t *bytes, size_t len) {
+        touchBytesEng(bytes, bytes, len);
+    }
+
+    void writeByte(uint8_t byte) {
+        touchBytesEng(&byte, NULL, 1);
+    }
+
+    void writeBytes(const uint8_t *bytes, size_t len) {
+        touchBytesEng(bytes, NULL, len);
+    }
+
+    uint8_t readByte() {
+        uint8_t ret;
+        touchBytesEng(NULL, &ret, 1);
+        return ret;
+    }
+
+    void readBytes(uint8_t *bytes, size_t len) {
+        touchBytesEng(NULL, bytes, len);
+    }
+
+    /**
+     * Search triplet. Both read slots are transmitted in a single burst.
+     */
+    int touchTriplet(int dir)
+    {
+        uint8_t bits[2] = {1, 1};
+
+        unpower();
+        touchBitsEng(bits, bits, 2);
+
+        int v0 = bits[0];
+        int v1 = bits[1];
+
+        if (v1 && v0)
+            return 3;
+
+        if (v1 || v0)
+            dir = !v1;
+
+        bits[0] = (dir ? 1 : 0);
+        touchBitsEng(bits, bits, 1);
+
+        return (v0 | (v1 << 1) | (dir ? 4 : 0));
+    }
+
+    /**
+     * Enable/disable direct voltage source provisioning on the 1-wire data
+     * bus (the bus GPIO switched to the push-pull mode, driven high by the
+     * idle RMT TX channel).
+     */
+    ErrorCode powerBus(bool on)
+    {
+        gpio_set_direction(_pin,
+            (on ? GPIO_MODE_INPUT_OUTPUT : GPIO_MODE_INPUT_OUTPUT_OD));
+        _pwr = on;
+        return EC_SUCCESS;
+    }
+
+protected:
+    /** RMT ticks per usec (80MHz APB clock divided by 8) */
+    const static unsigned TICKS_PER_US = 10;
+
+    /**
+     * RX idle threshold (usec); the bus state unchanged for a longer time
+     * finishes a burst recording and the burst is completed only after the
+     * threshold elapses. The threshold must exceed the longest bus state
+     * within a burst of slots (64 usec).
+     */
+    const static unsigned RX_IDLE_US = 100;
+
+    /**
+     * RX idle threshold for the standard speed reset (usec). The threshold
+     * must exceed the reset pulse (480 usec), otherwise the presence pulse is
+     * not recorded, and fit 15-bit RMT ticks counter (max. 3276 usec).
+     */
+    const static unsigned RX_IDLE_RESET_US = STD_RESET_LOW + 120;
+
+    /** RX reception timeout (msec) */
+    const static unsigned RX_TIMEOUT_MS = 20;
+
+    void initRmt(bool pullUp)
+    {
+#if IDF_IS_TARGET_ESP32C3
+        assert(_pin > 0 && _pin < 22);
+        assert(_txCh < RMT_CHANNEL_2 && _rxCh == RMT_CHANNEL_2);
+#else
+        /* pins above 33 can only be inputs */
+        assert(_pin < 34);
+        assert(_txCh != _rxCh && _txCh != _rxCh + 1);
+#endif
+        rmt_config_t rx = RMT_DEFAULT_CONFIG_RX(_pin, _rxCh);
+        rx.clk_div = 80 / TICKS_PER_US;
+        rx.mem_block_num = 2;
+        rx.rx_config.filter_en = true;
+        rx.rx_config.filter_ticks_thresh = 30;
+        rx.rx_config.idle_threshold = RX_IDLE_US * TICKS_PER_US;
+        rmt_config(&rx);
+        rmt_driver_install(_rxCh,
+            2 * sizeof(rmt_item32_t) * (8 * CONFIG_ESP32_RMT_BURST_BYTES + 2), 0);
+        rmt_get_ringbuf_handle(_rxCh, &_rb);
+
+        rmt_config_t tx = RMT_DEFAULT_CONFIG_TX(_pin, _txCh);
+        tx.clk_div = 80 / TICKS_PER_US;
+        tx.tx_config.idle_output_en = true;
+        tx.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH;
+        rmt_config(&tx);
+        rmt_driver_install(_txCh, 0, 0);
+
+        /* TX and RX share open-drain GPIO */
+        pinMode(_pin, INPUT | (pullUp ? PULLUP : 0));
+        gpio_set_direction(_pin, GPIO_MODE_INPUT_OUTPUT_OD);
+        __GPIO_CONNECT_OUT(_pin, RMT_SIG_OUT0_IDX + _txCh);
+#if IDF_IS_TARGET_ESP32C3
+        __GPIO_CONNECT_IN(_pin, RMT_SIG_IN0_IDX + (_rxCh - RMT_CHANNEL_2));
+#else
+        __GPIO_CONNECT_IN(_pin, RMT_SIG_IN0_IDX + _rxCh);
+#endif
+    }
+
+    /**
+     * Set RMT @c item: @c low usecs of low state followed by @c high usecs
+     * of high state.
+     */
+    static void setItem(rmt_item32_t& item, int low, int high)
+    {
+        item.level0 = 0;
+        item.duration0 = (low > 0 ? low * TICKS_PER_US : TICKS_PER_US);
+        item.level1 = 1;
+        item.duration1 = (high > 0 ? high * TICKS_PER_US : TICKS_PER_US);
+    }
+
+    /**
+     * Transmit @c n items and record the bus state. Widths of the recorded
+     * low pulses (in ticks) are written into @c lowTicks (if not @c NULL,
+     * @c n entries max.), their number is written under @c lows. The
+     * recording is finished by the bus state unchanged for @c idleUs.
+     */
+    esp_err_t xfer(const rmt_item32_t *items, size_t n,
+        uint16_t *lowTicks, unsigned *lows, unsigned idleUs = RX_IDLE_US)
+    {
+        size_t size = 0;
+        rmt_item32_t *rx;
+
+        *lows = 0;
+        if (idleUs != RX_IDLE_US)
+            rmt_set_rx_idle_thresh(_rxCh, (uint16_t)(idleUs * TICKS_PER_US));
+
+        rmt_rx_start(_rxCh, true);
+        esp_err_t err = rmt_write_items(_txCh, items, n, true);
+
+        rx = (rmt_item32_t*)xRingbufferReceive(
+            _rb, &size, pdMS_TO_TICKS(RX_TIMEOUT_MS));
+        rmt_rx_stop(_rxCh);
+
+        if (idleUs != RX_IDLE_US)
+            rmt_set_rx_idle_thresh(_rxCh, RX_IDLE_US * TICKS_PER_US);
+
+        if (!rx)
+            return (err != ESP_OK ? err : ESP_ERR_TIMEOUT);
+
+        for (size_t i = 0; i < size / sizeof(rmt_item32_t); i++)
+        {
+            /* zero duration marks the end of the recorded frame */
+            if (!rx[i].duration0) break;
+            if (!rx[i].level0) {
+                if (lowTicks && *lows < n) lowTicks[*lows] = rx[i].duration0;
+                (*lows)++;
+            }
+            if (!rx[i].duration1) break;
+            if (!rx[i].level1) {
+                if (lowTicks && *lows < n) lowTicks[*lows] = rx[i].duration1;
+                (*lows)++;
+            }
+        }
+        vRingbufferReturnItem(_rb, rx);
+        return err;
+    }
+
+    /**
+     * Bits touching engine. Touch @c n bits from @c in (one bit per byte)
+     * in a single burst and write the result into @c out.
+     */
+    void touchBitsEng(const uint8_t *in, uint8_t *out, size_t n)
+    {
+        unsigned smplTicks, lows;
+
+#ifdef CONFIG_OVERDRIVE_ENABLED
+        if (_overdrive) {
+            for (size_t i = 0; i < n; i++) {
+                if (in[i]) {
+                    setItem(_items[i], OD_WRITE1_LOW, OD_WRITE1_END);
+                } else {
+                    setItem(_items[i], OD_WRITE0_LOW, OD_WRITE0_END);
+                }
+            }
+            /* sampling max 2 usec after the slot start */
+            smplTicks = 2 * TICKS_PER_US;
+        } else
+#endif
+        {
+            for (size_t i = 0; i < n; i++) {
+                if (in[i]) {
+                    setItem(_items[i], STD_WRITE1_LOW,
+                        STD_WRITE1_SMPL + STD_WRITE1_END);
+                } else {
+                    setItem(_items[i], STD_WRITE0_LOW, STD_WRITE0_END);
+                }
+            }
+            smplTicks = (STD_WRITE1_LOW + STD_WRITE1_SMPL) * TICKS_PER_US;
+        }
+
+        if (xfer(_items, n, _lowTicks, &lows) != ESP_OK || lows != n) {
+            /* released bus is read on error */
+            for (size_t i = 0; i < n; i++)
+                out[i] = 1;
+        } else {
+            for (size_t i = 0; i < n; i++)
+                out[i] = (in[i] && _lowTicks[i] <= smplTicks);
+        }
+    }
+
+    /**
+     * Bytes touching engine. Touch @c len bytes from @c in (@c 0xff bytes
+     * are touched if @c NULL) and write the result into @c out (the result
+     * is not stored if @c NULL). @c in and @c out may point to the same
+     * buffer.
+     */
+    void touchBytesEng(const uint8_t *in, uint8_t *out, size_t len)
+    {
+        uint8_t bits[8 * CONFIG_ESP32_RMT_BURST_BYTES];
+
+        unpower();
+        while (len > 0)
+        {
+            size_t n = (len < CONFIG_ESP32_RMT_BURST_BYTES ?
+                len : CONFIG_ESP32_RMT_BURST_BYTES);
+
+            /* LSB first */
+            for (size_t i = 0; i < n; i++) {
+                uint8_t byte = (in ? in[i] : 0xff);
+                for (int j = 0; j < 8; j++, byte >>= 1)
+                    bits[8*i + j] = (byte & 1);
+            }
+
+            touchBitsEng(bits, bits, 8*n);
+
+            if (out) {
+                for (size_t i = 0; i < n; i++) {
+                    uint8_t ret = 0;
+                    for (int j = 0; j < 8; j++) {
+                        if (bits[8*i + j])
+                            ret |= (uint8_t)(1 << j);
+                    }
+                    out[i] = ret;
+                }
+                out += n;
+            }
+            if (in) in += n;
+            len -= n;
+        }
+    }
+
+    void unpower() {
+        if (_pwr) powerBus(false);
+    }
+
+    gpio_num_t _pin;
+    rmt_channel_t _txCh;
+    rmt_channel_t _rxCh;
+    RingbufHandle_t _rb;
+    bool _pwr;
+
+    rmt_item32_t _items[8 * CONFIG_ESP32_RMT_BURST_BYTES];
+    uint16_t _lowTicks[8 * CONFIG_ESP32_RMT_BURST_BYTES];
+};
+
+#undef __GPIO_CONNECT_IN
+#undef __GPIO_CONNECT_OUT
+
+#endif /* __OWNG_ARDUINO_ESP32_RMT__ */
@@ -15,7 +15,7 @@
 
 #include <assert.h>
 #include "Arduino.h"
-#include "OneWireNg_BitBang.h"
+#include "OneWireNg_BitBangT.h"
 
 #define __READ_GPIO(gs) \
     ((*gs.inReg & gs.bmsk) != 0)
@@ -48,8 +48,10 @@
 /**
  * Arduino ESP8266 platform GPIO specific implementation.
  */
-class OneWireNg_ArduinoESP8266: public OneWireNg_BitBang
+class OneWireNg_ArduinoESP8266: public OneWireNg_BitBangT<OneWireNg_ArduinoESP8266>
 {
+    friend class OneWireNg_BitBangT<OneWireNg_ArduinoESP8266>;
+
 public:
     /**
      * OneWireNg 1-wire service for Arduino ESP8266 platform.
@@ -62,7 +64,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoESP8266(unsigned pin, bool pullUp):
-        OneWireNg_BitBang(false)
+        OneWireNg_BitBangT<OneWireNg_ArduinoESP8266>(false)
     {
         initDtaGpio(pin, pullUp);
     }
@@ -72,7 +74,7 @@ public:
      *
      * Bus powering is supported via a switching transistor providing
      * the power to the bus and controlled by a dedicated GPIO (@see
-     * OneWireNg_BitBang::setupPwrCtrlGpio()). In this configuration the
+     * OneWireNg_BitBangT::setupPwrCtrlGpio()). In this configuration the
      * service mimics the open-drain type of output. The approach may be
      * feasible if the GPIO is unable to provide sufficient power for
      * connected slaves working in parasite powering configuration.
@@ -83,7 +85,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoESP8266(unsigned pin, unsigned pwrCtrlPin, bool pullUp):
-        OneWireNg_BitBang(true)
+        OneWireNg_BitBangT<OneWireNg_ArduinoESP8266>(true)
     {
         initDtaGpio(pin, pullUp);
         initPwrCtrlGpio(pwrCtrlPin);
@@ -15,7 +15,7 @@
 
 #include <assert.h>
 #include "Arduino.h"
-#include "OneWireNg_BitBang.h"
+#include "OneWireNg_BitBangT.h"
 
 #define __READ_GPIO(gs) \
     ((gs.port->IN & gs.bmsk) != 0)
@@ -34,8 +34,10 @@
  * Arduino megaAVR platform GPIO specific implementation
  * (this is recent Microchip architecture: ATmega4809, 4808, 3209, 3208).
  */
-class OneWireNg_ArduinoMegaAVR: public OneWireNg_BitBang
+class OneWireNg_ArduinoMegaAVR: public OneWireNg_BitBangT<OneWireNg_ArduinoMegaAVR>
 {
+    friend class OneWireNg_BitBangT<OneWireNg_ArduinoMegaAVR>;
+
 public:
     /**
      * OneWireNg 1-wire service for Arduino megaAVR platform.
@@ -48,7 +50,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoMegaAVR(unsigned pin, bool pullUp):
-        OneWireNg_BitBang(false)
+        OneWireNg_BitBangT<OneWireNg_ArduinoMegaAVR>(false)
     {
         initDtaGpio(pin, pullUp);
     }
@@ -58,7 +60,7 @@ public:
      *
      * Bus powering is supported via a switching transistor providing
      * the power to the bus and controlled by a dedicated GPIO (@see
-     * OneWireNg_BitBang::setupPwrCtrlGpio()). In this configuration the
+     * OneWireNg_BitBangT::setupPwrCtrlGpio()). In this configuration the
      * service mimics the open-drain type of output. The approach may be
      * feasible if the GPIO is unable to provide sufficient power for
      * connected slaves working in parasite powering configuration.
@@ -69,7 +71,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoMegaAVR(unsigned pin, unsigned pwrCtrlPin, bool pullUp):
-        OneWireNg_BitBang(true)
+        OneWireNg_BitBangT<OneWireNg_ArduinoMegaAVR>(true)
     {
         initDtaGpio(pin, pullUp);
         initPwrCtrlGpio(pwrCtrlPin);
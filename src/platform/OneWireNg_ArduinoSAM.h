@@ -15,7 +15,7 @@
 
 #include <assert.h>
 #include "Arduino.h"
-#include "OneWireNg_BitBang.h"
+#include "OneWireNg_BitBangT.h"
 
 /* if defined - internal Arduino pin status in updated */
 //#define PIN_STATUS_UPDATE
@@ -36,8 +36,10 @@
 /**
  * Arduino SAM platform GPIO specific implementation.
  */
-class OneWireNg_ArduinoSAM: public OneWireNg_BitBang
+class OneWireNg_ArduinoSAM: public OneWireNg_BitBangT<OneWireNg_ArduinoSAM>
 {
+    friend class OneWireNg_BitBangT<OneWireNg_ArduinoSAM>;
+
 public:
     /**
      * OneWireNg 1-wire service for Arduino SAM platform.
@@ -50,7 +52,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoSAM(unsigned pin, bool pullUp):
-        OneWireNg_BitBang(false)
+        OneWireNg_BitBangT<OneWireNg_ArduinoSAM>(false)
     {
         initDtaGpio(pin, pullUp);
     }
@@ -60,7 +62,7 @@ public:
      *
      * Bus powering is supported via a switching transistor providing
      * the power to the bus and controlled by a dedicated GPIO (@see
-     * OneWireNg_BitBang::setupPwrCtrlGpio()). In this configuration the
+     * OneWireNg_BitBangT::setupPwrCtrlGpio()). In this configuration the
      * service mimics the open-drain type of output. The approach may be
      * feasible if the GPIO is unable to provide sufficient power for
      * connected slaves working in parasite powering configuration.
@@ -71,7 +73,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoSAM(unsigned pin, unsigned pwrCtrlPin, bool pullUp):
-        OneWireNg_BitBang(true)
+        OneWireNg_BitBangT<OneWireNg_ArduinoSAM>(true)
     {
         initDtaGpio(pin, pullUp);
         initPwrCtrlGpio(pwrCtrlPin);
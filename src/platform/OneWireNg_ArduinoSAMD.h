@@ -15,7 +15,7 @@
 
 #include <assert.h>
 #include "Arduino.h"
-#include "OneWireNg_BitBang.h"
+#include "OneWireNg_BitBangT.h"
 
 #define __READ_GPIO(gs) \
     ((*gs.inReg & gs.bmsk) != 0)
@@ -33,8 +33,10 @@
 /**
  * Arduino SAMD platform GPIO specific implementation.
  */
-class OneWireNg_ArduinoSAMD: public OneWireNg_BitBang
+class OneWireNg_ArduinoSAMD: public OneWireNg_BitBangT<OneWireNg_ArduinoSAMD>
 {
+    friend class OneWireNg_BitBangT<OneWireNg_ArduinoSAMD>;
+
 public:
     /**
      * OneWireNg 1-wire service for Arduino SAMD platform.
@@ -47,7 +49,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoSAMD(unsigned pin, bool pullUp):
-        OneWireNg_BitBang(false)
+        OneWireNg_BitBangT<OneWireNg_ArduinoSAMD>(false)
     {
         initDtaGpio(pin, pullUp);
     }
@@ -57,7 +59,7 @@ public:
      *
      * Bus powering is supported via a switching transistor providing
      * the power to the bus and controlled by a dedicated GPIO (@see
-     * OneWireNg_BitBang::setupPwrCtrlGpio()). In this configuration the
+     * OneWireNg_BitBangT::setupPwrCtrlGpio()). In this configuration the
      * service mimics the open-drain type of output. The approach may be
      * feasible if the GPIO is unable to provide sufficient power for
      * connected slaves working in parasite powering configuration.
@@ -68,7 +70,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoSAMD(unsigned pin, unsigned pwrCtrlPin, bool pullUp):
-        OneWireNg_BitBang(true)
+        OneWireNg_BitBangT<OneWireNg_ArduinoSAMD>(true)
     {
         initDtaGpio(pin, pullUp);
         initPwrCtrlGpio(pwrCtrlPin);
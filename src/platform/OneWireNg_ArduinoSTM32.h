@@ -15,13 +15,15 @@
 
 #include <assert.h>
 #include "Arduino.h"
-#include "OneWireNg_BitBang.h"
+#include "OneWireNg_BitBangT.h"
 
 /**
  * Arduino STM32 platform GPIO specific implementation.
  */
-class OneWireNg_ArduinoSTM32: public OneWireNg_BitBang
+class OneWireNg_ArduinoSTM32: public OneWireNg_BitBangT<OneWireNg_ArduinoSTM32>
 {
+    friend class OneWireNg_BitBangT<OneWireNg_ArduinoSTM32>;
+
 public:
     /**
      * OneWireNg 1-wire service for Arduino STM32 platform.
@@ -34,7 +36,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoSTM32(unsigned pin, bool pullUp):
-        OneWireNg_BitBang(false)
+        OneWireNg_BitBangT<OneWireNg_ArduinoSTM32>(false)
     {
         initDtaGpio(pin, pullUp);
     }
@@ -44,7 +46,7 @@ public:
      *
      * Bus powering is supported via a switching transistor providing
      * the power to the bus and controlled by a dedicated GPIO (@see
-     * OneWireNg_BitBang::setupPwrCtrlGpio()). In this configuration the
+     * OneWireNg_BitBangT::setupPwrCtrlGpio()). In this configuration the
      * service mimics the open-drain type of output. The approach may be
      * feasible if the GPIO is unable to provide sufficient power for
      * connected slaves working in parasite powering configuration.
@@ -55,7 +57,7 @@ public:
      * @param pullUp If @c true configure internal pull-up resistor for the bus.
      */
     OneWireNg_ArduinoSTM32(unsigned pin, unsigned pwrCtrlPin, bool pullUp):
-        OneWireNg_BitBang(true)
+        OneWireNg_BitBangT<OneWireNg_ArduinoSTM32>(true)
     {
         initDtaGpio(pin, pullUp);
         initPwrCtrlGpio(pwrCtrlPin);
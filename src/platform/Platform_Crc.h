@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021 Piotr Stolarz
+ * OneWireNg: Ardiono 1-wire service library
+ *
+ * Distributed under the 2-clause BSD License (the License)
+ * see accompanying file LICENSE for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+/*
+ * Platform specific CRC calculation engines.
+ *
+ * The header defines the following macros for the supported platforms:
+ *
+ * PLATFORM_CRC_FOLD: The platform provides CRC folding routine:
+ *
+ *     size_t platformCrcFold(const void *in, size_t len, uint16_t crc_in,
+ *         uint64_t k1, uint64_t k2, uint8_t *out);
+ *
+ *     The routine folds @c len bytes of (reflected) CRC input @c in, starting
+ *     with @c crc_in CRC value, into 16 bytes written to @c out. The folded
+ *     bytes has the same CRC (with 0 as the starting CRC) as the input folded.
+ *     @c k1, @c k2 are the folding constants (x^191 mod P, x^127 mod P
+ *     respectively, as 64-bit bit-reflected values) for the CRC polynomial P.
+ *     Number of folded input bytes is returned (0: the folding is not
+ *     performed - too short input or the engine is not available).
+ *
+ * PLATFORM_CRC8, PLATFORM_CRC16: The platform provides CRC-8/MAXIM, CRC-16/ARC
+ *     calculation engines (arguments as for @ref OneWireNg::crc8(),
+ *     @ref OneWireNg::crc16()):
+ *
+ *     uint8_t platformCrc8(const void *in, size_t len, uint8_t crc_in);
+ *     uint16_t platformCrc16(const void *in, size_t len, uint16_t crc_in);
+ *
+ * Supported platforms:
+ * - x86-64 (GCC, clang): PCLMULQDQ based CRC folding. The instruction
+ *   availability is checked at runtime.
+ * - STM32 equipped with programmable polynomial CRC calculation unit (STM32F0,
+ *   F3, F7, L0, L4, G0, G4, H7 and others). The CRC unit is reconfigured on
+ *   each calculation, therefore it shall not be used concurrently by other
+ *   modules.
+ *
+ * NOTE: ESP32 ROM CRC routines (crc8_le(), crc16_le()) are not usable by
+ * the library, since they implement different CRC polynomials (CRC-8 0x07,
+ * CRC-16/CCITT 0x1021) than the ones used by 1-wire devices.
+ */
+#ifndef __OWNG_PLATFORM_CRC__
+#define __OWNG_PLATFORM_CRC__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+# include <immintrin.h>
+# define PLATFORM_CRC_FOLD
+
+__attribute__((target("pclmul,sse2")))
+static size_t __platformCrcFoldClmul(const uint8_t *in, size_t len,
+    uint16_t crc_in, uint64_t k1, uint64_t k2, uint8_t *out)
+{
+    /* initial CRC is XORed with the first input bytes (reflected CRC) */
+    __m128i fld = _mm_xor_si128(
+        _mm_loadu_si128((const __m128i*)in), _mm_cvtsi32_si128(crc_in));
+    __m128i k = _mm_set_epi64x((long long)k2, (long long)k1);
+
+    size_t n = 16;
+    for (; len - n >= 16; n += 16) {
+        /* fld * x^128 mod P folded with the next 16 bytes of the input */
+        fld = _mm_xor_si128(
+            _mm_xor_si128(
+                _mm_clmulepi64_si128(fld, k, 0x00),
+                _mm_clmulepi64_si128(fld, k, 0x11)),
+            _mm_loadu_si128((const __m128i*)(in + n)));
+    }
+    _mm_storeu_si128((__m128i*)out, fld);
+    return n;
+}
+
+static inline size_t platformCrcFold(const void *in, size_t len,
+    uint16_t crc_in, uint64_t k1, uint64_t k2, uint8_t *out)
+{
+    /* 0: not checked, 1: supported, -1: not supported */
+    static int clmul = 0;
+
+    /* folding is not profitable for short inputs */
+    if (len < 64)
+        return 0;
+
+    if (!clmul) {
+        __builtin_cpu_init();
+        clmul = (__builtin_cpu_supports("pclmul") ? 1 : -1);
+    }
+    return (clmul > 0 ?
+        __platformCrcFoldClmul((const uint8_t*)in, len, crc_in, k1, k2, out) :
+        0);
+}
+
+#elif defined(ARDUINO_ARCH_STM32) && defined(CRC_POL_POL)
+# include "Arduino.h"
+# define PLATFORM_CRC8
+# define PLATFORM_CRC16
+
+/* reverse @c bits lowest bits of @c v */
+static inline uint32_t __platformCrcRev(uint32_t v, int bits)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < bits; i++, v >>= 1)
+        r = (r << 1) | (v & 1);
+    return r;
+}
+
+/*
+ * Calculate reflected CRC of @c polySize bits polynomial @c poly (normal,
+ * not reversed representation) by the CRC unit.
+ */
+static inline uint32_t __platformCrcCalc(const void *in, size_t len,
+    uint32_t crc_in, uint32_t poly, uint32_t polySize, int bits)
+{
+    const uint8_t *in_bts = (const uint8_t*)in;
+
+    __HAL_RCC_CRC_CLK_ENABLE();
+
+    CRC->POL = poly;
+    /* bit-reversed input (by byte) and output */
+    CRC->CR = polySize | CRC_CR_REV_IN_0 | CRC_CR_REV_OUT;
+    /* initial value is not reversed by the unit */
+    CRC->INIT = __platformCrcRev(crc_in, bits);
+    CRC->CR |= CRC_CR_RESET;
+
+    while (len--)
+        *(volatile uint8_t*)&CRC->DR = *in_bts++;
+
+    return CRC->DR;
+}
+
+static inline uint8_t platformCrc8(const void *in, size_t len, uint8_t crc_in)
+{
+    return (uint8_t)__platformCrcCalc(
+        in, len, crc_in, 0x31, CRC_CR_POLYSIZE_1, 8);
+}
+
+static inline uint16_t platformCrc16(
+    const void *in, size_t len, uint16_t crc_in)
+{
+    return (uint16_t)__platformCrcCalc(
+        in, len, crc_in, 0x8005, CRC_CR_POLYSIZE_0, 16);
+}
+
+#endif
+
+#endif /* __OWNG_PLATFORM_CRC__ */
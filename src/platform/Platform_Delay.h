@@ -19,9 +19,13 @@
 # define delayMs(__ms) delay(__ms)
 #else
 # ifdef __TEST__
-#  include <unistd.h>
-#  define delayUs(__us) usleep(__us)
-#  define delayMs(__ms) usleep(1000L * (__ms))
+/*
+ * Host builds: delays advance virtual clock of a simulated 1-wire bus (see
+ * OneWireNg_Simulated::setDelayBus()), or sleep if there is no such bus.
+ */
+void hostDelayUs(unsigned long us);
+#  define delayUs(__us) hostDelayUs(__us)
+#  define delayMs(__ms) hostDelayUs(1000UL * (__ms))
 # else
 #  error "ERROR: Delay API unsupported for the target platform."
 # endif